@@ -5,25 +5,37 @@
 #include <vector>
 #include <cstring>
 #include <algorithm>
+#include <type_traits>
+#include <fstream>
+#include <string_view>
+#include <utility>
 #include "crypto/symmetric/DES.hpp"
 #include "crypto/symmetric/TripleDES.hpp"
 #include "crypto/symmetric/DEAL.hpp"
 #include "crypto/modes/ECB.hpp"
 #include "crypto/modes/CBC.hpp"
 #include "crypto/modes/CTR.hpp"
+#include "crypto/modes/Mode.hpp"
+#include "crypto/modes/AuthenticatedCBC.hpp"
 #include "crypto/modes/RandomDelta.hpp"
 #include "crypto/padding/PKCS7.hpp"
 #include "crypto/padding/ANSIX923.hpp"
 #include "crypto/padding/ISO10126.hpp"
 #include "crypto/padding/Zeros.hpp"
+#include "crypto/symmetric/SharedCipher.hpp"
 #include "crypto/utils/FileProcessor.hpp"
+#include "crypto/utils/BatchProcessor.hpp"
+#include "crypto/utils/CpuFeatures.hpp"
 using namespace crypto;
 void printUsage() {
     std::cout << "Usage: lab1 <mode> <algo> <padding> <key> <input_file> <output_file> [enc|dec]\n";
+    std::cout << "       lab1 batch <mode> <algo> <padding> <key> <input_dir|manifest> <output_dir> <enc|dec> [report.tsv]\n";
     std::cout << "Options:\n";
-    std::cout << "  Modes:   ECB, CBC, CTR, RD (RandomDelta)\n";
+    std::cout << "  Modes:   ECB, CBC, CTR, RD (RandomDelta), RDP (RandomDelta, Philox deltas),\n";
+    std::cout << "           CBC-CMAC (CBC with appended CMAC tag)\n";
     std::cout << "  Algos:   DES, 3DES, DEAL\n";
     std::cout << "  Padding: PKCS7, ANSI, ISO, Zeros\n";
+    std::cout << "  Manifest: one input path per line, optionally followed by a tab and an output path\n";
     std::cout << "Example: lab1 CBC DES PKCS7 mysecretkey data.bin out.bin enc\n";
 }
 Bytes prepareKey(const Bytes& rawKey, size_t requiredSize) {
@@ -38,8 +50,130 @@ Bytes prepareKey(const Bytes& rawKey, size_t requiredSize) {
 Bytes generateIV(size_t size) {
     return Bytes(size, Byte{0});
 }
+size_t keySizeFor(const std::string& algoStr) {
+    if (algoStr == "DES") return 8;
+    if (algoStr == "3DES") return 24;
+    if (algoStr == "DEAL") return 16;
+    throw std::invalid_argument("Unknown algorithm: " + algoStr);
+}
+std::unique_ptr<IBlockCipher> makeCipher(const std::string& algoStr, const Bytes& rawKey) {
+    Bytes key = prepareKey(rawKey, keySizeFor(algoStr));
+    if (algoStr == "DES") return std::make_unique<symmetric::DES>(key);
+    if (algoStr == "3DES") return std::make_unique<symmetric::TripleDES>(key);
+    return std::make_unique<symmetric::DEAL>(key);
+}
+std::pair<std::unique_ptr<IBlockCipher>, std::unique_ptr<IBlockCipher>> makeCiphers(const std::string& modeStr, const std::string& algoStr,
+                                                                                    const Bytes& rawKey) {
+    if (modeStr != "CBC-CMAC") return {makeCipher(algoStr, rawKey), nullptr};
+    auto derive = [&](std::string_view label) {
+        return makeCipher(algoStr, modes::CMAC::deriveKey(makeCipher(algoStr, rawKey), label, keySizeFor(algoStr)));
+    };
+    return {derive("lab1 CBC-CMAC encryption"), derive("lab1 CBC-CMAC authentication")};
+}
+std::unique_ptr<IPadding> makePadding(const std::string& padStr) {
+    if (padStr == "PKCS7") return std::make_unique<padding::PKCS7>();
+    if (padStr == "ANSI") return std::make_unique<padding::ANSIX923>();
+    if (padStr == "ISO") return std::make_unique<padding::ISO10126>();
+    if (padStr == "Zeros") return std::make_unique<padding::Zeros>();
+    if (padStr == "None") return nullptr;
+    throw std::invalid_argument("Unknown padding: " + padStr);
+}
+template<typename Chaining, typename Cipher, typename Padding>
+std::unique_ptr<ICipherMode> makeComposed(ConstBytesSpan key, size_t blockSize) {
+    if constexpr (std::is_same_v<Chaining, modes::ECB>) return std::make_unique<modes::Mode<Chaining, Cipher, Padding>>(key);
+    else return std::make_unique<modes::Mode<Chaining, Cipher, Padding>>(key, generateIV(blockSize));
+}
+template<typename Chaining, typename Cipher>
+std::unique_ptr<ICipherMode> makeComposed(const std::string& padStr, ConstBytesSpan key, size_t blockSize) {
+    if constexpr (std::is_same_v<Chaining, modes::CTR>) {
+        return makeComposed<Chaining, Cipher, void>(key, blockSize);
+    } else {
+        if (padStr == "PKCS7") return makeComposed<Chaining, Cipher, padding::PKCS7>(key, blockSize);
+        if (padStr == "ANSI") return makeComposed<Chaining, Cipher, padding::ANSIX923>(key, blockSize);
+        if (padStr == "ISO") return makeComposed<Chaining, Cipher, padding::ISO10126>(key, blockSize);
+        if (padStr == "Zeros") return makeComposed<Chaining, Cipher, padding::Zeros>(key, blockSize);
+        if (padStr == "None") throw std::invalid_argument("ECB and CBC require padding");
+        throw std::invalid_argument("Unknown padding: " + padStr);
+    }
+}
+template<typename Chaining>
+std::unique_ptr<ICipherMode> makeComposed(const std::string& algoStr, const std::string& padStr, const Bytes& rawKey) {
+    if (algoStr == "DES") return makeComposed<Chaining, symmetric::DES>(padStr, prepareKey(rawKey, 8), 8);
+    if (algoStr == "3DES") return makeComposed<Chaining, symmetric::TripleDES>(padStr, prepareKey(rawKey, 24), 8);
+    if (algoStr == "DEAL") return makeComposed<Chaining, symmetric::DEAL>(padStr, prepareKey(rawKey, 16), 16);
+    throw std::invalid_argument("Unknown algorithm: " + algoStr);
+}
+std::unique_ptr<ICipherMode> makeMode(const std::string& modeStr, std::unique_ptr<IBlockCipher> cipher,
+                                      std::unique_ptr<IBlockCipher> macCipher, const std::string& padStr) {
+    size_t bs = cipher->getBlockSize();
+    if (modeStr == "CTR") return std::make_unique<modes::CTR>(std::move(cipher), generateIV(bs));
+    auto padding = makePadding(padStr);
+    if (!padding) throw std::invalid_argument(modeStr + " requires padding");
+    if (modeStr == "ECB") return std::make_unique<modes::ECB>(std::move(cipher), std::move(padding));
+    if (modeStr == "CBC") return std::make_unique<modes::CBC>(std::move(cipher), std::move(padding), generateIV(bs));
+    if (modeStr == "CBC-CMAC") {
+        return std::make_unique<modes::AuthenticatedCBC>(std::move(cipher), std::move(macCipher), std::move(padding), generateIV(bs));
+    }
+    if (modeStr == "RD") return std::make_unique<modes::RandomDelta>(std::move(cipher), std::move(padding), generateIV(4));
+    if (modeStr == "RDP") {
+        return std::make_unique<modes::RandomDelta>(std::move(cipher), std::move(padding), generateIV(8), modes::DeltaGenerator::Philox);
+    }
+    throw std::invalid_argument("Unknown mode: " + modeStr);
+}
+Bytes toBytes(const std::string& keyStr) {
+    Bytes rawKey;
+    rawKey.reserve(keyStr.size());
+    for (char c : keyStr) rawKey.push_back(static_cast<Byte>(c));
+    return rawKey;
+}
+void validateModeArgs(const utils::BatchProcessor::ModeFactory& factory) {
+    if (!factory()) throw std::runtime_error("Mode factory returned no mode");
+}
+int runBatch(int argc, char* argv[]) {
+    if (argc != 9 && argc != 10) {
+        printUsage();
+        return 1;
+    }
+    std::string modeStr = argv[2];
+    std::string algoStr = argv[3];
+    std::string padStr = argv[4];
+    Bytes rawKey = toBytes(argv[5]);
+    std::filesystem::path input = argv[6];
+    std::filesystem::path outputDir = argv[7];
+    std::string operation = argv[8];
+    if (operation != "enc" && operation != "dec") {
+        printUsage();
+        return 1;
+    }
+    bool encrypt = operation == "enc";
+    auto ciphers = makeCiphers(modeStr, algoStr, rawKey);
+    std::shared_ptr<IBlockCipher> cipher = std::move(ciphers.first);
+    std::shared_ptr<IBlockCipher> macCipher = std::move(ciphers.second);
+    utils::BatchProcessor::ModeFactory factory = [&] {
+        return makeMode(modeStr, std::make_unique<symmetric::SharedCipher>(cipher),
+                        macCipher ? std::make_unique<symmetric::SharedCipher>(macCipher) : nullptr, padStr);
+    };
+    validateModeArgs(factory);
+    auto jobs = std::filesystem::is_directory(input)
+        ? utils::BatchProcessor::scanDirectory(input, outputDir)
+        : utils::BatchProcessor::readManifest(input, outputDir);
+    std::cout << "Config: " << algoStr << "/" << modeStr << "/" << padStr << "\n";
+    std::cout << "Operation: " << (encrypt ? "Encrypting" : "Decrypting") << " " << jobs.size() << " files...\n";
+    auto results = utils::BatchProcessor::run(jobs, factory, encrypt);
+    if (argc == 10) {
+        std::ofstream report(argv[9]);
+        if (!report) throw std::runtime_error("Cannot open report file");
+        utils::BatchProcessor::writeReport(results, report);
+    } else {
+        utils::BatchProcessor::writeReport(results, std::cout);
+    }
+    auto failed = std::count_if(results.begin(), results.end(), [](const auto& r) { return !r.ok; });
+    std::cout << (results.size() - failed) << " succeeded, " << failed << " failed\n";
+    return failed == 0 ? 0 : 2;
+}
 int main(int argc, char* argv[]) {
     try {
+        if (argc > 1 && std::string(argv[1]) == "batch") return runBatch(argc, argv);
         if (argc != 8) {
             printUsage();
             return 1;
@@ -51,59 +185,25 @@ int main(int argc, char* argv[]) {
         std::filesystem::path inFile = argv[5];
         std::filesystem::path outFile = argv[6];
         bool encrypt = (std::string(argv[7]) == "enc");
-        Bytes rawKey;
-        rawKey.reserve(keyStr.size());
-        for (char c : keyStr) rawKey.push_back(static_cast<Byte>(c));
-        std::unique_ptr<IBlockCipher> cipher;
-        if (algoStr == "DES") {
-            cipher = std::make_unique<symmetric::DES>(prepareKey(rawKey, 8));
-        } else if (algoStr == "3DES") {
-            cipher = std::make_unique<symmetric::TripleDES>(prepareKey(rawKey, 24));
-        } else if (algoStr == "DEAL") {
-            cipher = std::make_unique<symmetric::DEAL>(prepareKey(rawKey, 16));
-        } else {
-            throw std::invalid_argument("Unknown algorithm: " + algoStr);
-        }
-        std::unique_ptr<IPadding> padding;
-        if (padStr == "PKCS7") {
-            padding = std::make_unique<padding::PKCS7>();
-        } else if (padStr == "ANSI") {
-            padding = std::make_unique<padding::ANSIX923>();
-        } else if (padStr == "ISO") {
-            padding = std::make_unique<padding::ISO10126>();
-        } else if (padStr == "Zeros") {
-            padding = std::make_unique<padding::Zeros>();
-        } else if (padStr == "None") {
-            padding = nullptr;
-        } else {
-            throw std::invalid_argument("Unknown padding: " + padStr);
-        }
+        Bytes rawKey = toBytes(keyStr);
         std::unique_ptr<ICipherMode> mode;
-        size_t blockSize = cipher->getBlockSize();
         if (modeStr == "ECB") {
-            if (!padding) throw std::invalid_argument("ECB requires padding");
-            mode = std::make_unique<modes::ECB>(std::move(cipher), std::move(padding));
+            mode = makeComposed<modes::ECB>(algoStr, padStr, rawKey);
         }
         else if (modeStr == "CBC") {
-            if (!padding) throw std::invalid_argument("CBC requires padding");
-            Bytes iv = generateIV(blockSize);
-            mode = std::make_unique<modes::CBC>(std::move(cipher), std::move(padding), iv);
+            mode = makeComposed<modes::CBC>(algoStr, padStr, rawKey);
         }
         else if (modeStr == "CTR") {
-            Bytes iv = generateIV(blockSize);
-            mode = std::make_unique<modes::CTR>(std::move(cipher), iv);
-        }
-        else if (modeStr == "RD") {
-            if (!padding) throw std::invalid_argument("RandomDelta requires padding");
-            Bytes iv = generateIV(4);
-            mode = std::make_unique<modes::RandomDelta>(std::move(cipher), std::move(padding), iv);
+            mode = makeComposed<modes::CTR>(algoStr, padStr, rawKey);
         }
         else {
-            throw std::invalid_argument("Unknown mode: " + modeStr);
+            auto ciphers = makeCiphers(modeStr, algoStr, rawKey);
+            mode = makeMode(modeStr, std::move(ciphers.first), std::move(ciphers.second), padStr);
         }
         std::cout << "Config: " << algoStr << "/" << modeStr << "/" << padStr << "\n";
+        std::cout << "SIMD: " << utils::CpuFeatures::toString(utils::CpuFeatures::active()) << "\n";
         std::cout << "Operation: " << (encrypt ? "Encrypting" : "Decrypting") << "...\n";
-        utils::FileProcessor::process(inFile, outFile, *mode, encrypt);
+        utils::FileProcessor::process(inFile, outFile, *mode, encrypt, utils::FileProcessor::Backend::MemoryMapped);
         std::cout << "Success! Result written to " << outFile << "\n";
     } catch (const std::exception& e) {
         std::cerr << "\n[ERROR] " << e.what() << "\n";
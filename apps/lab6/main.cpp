@@ -3,6 +3,9 @@
 #include <filesystem>
 #include <memory>
 #include <vector>
+#include <fstream>
+#include <algorithm>
+#include <string_view>
 #include "crypto/symmetric/FROG.hpp"
 #include "crypto/modes/ECB.hpp"
 #include "crypto/modes/CBC.hpp"
@@ -12,15 +15,20 @@
 #include "crypto/padding/ANSIX923.hpp"
 #include "crypto/padding/ISO10126.hpp"
 #include "crypto/padding/Zeros.hpp"
+#include "crypto/symmetric/SharedCipher.hpp"
 #include "crypto/utils/FileProcessor.hpp"
+#include "crypto/utils/BatchProcessor.hpp"
+#include "crypto/utils/CpuFeatures.hpp"
 #include "crypto/modes/PCBC.hpp"
 #include "crypto/modes/CFB.hpp"
 #include "crypto/modes/OFB.hpp"
+#include "crypto/modes/AuthenticatedCBC.hpp"
 using namespace crypto;
 void printUsage() {
     std::cout << "Usage: lab6 <mode> <padding> <key> <input_file> <output_file> [enc|dec]\n";
+    std::cout << "       lab6 batch <mode> <padding> <key> <input_dir|manifest> <output_dir> <enc|dec> [report.tsv]\n";
     std::cout << "Algo is always FROG.\n";
-    std::cout << "Modes: ECB, CBC, CTR, RD\n";
+    std::cout << "Modes: ECB, CBC, CBC-CMAC, PCBC, CFB, CFB8, OFB, CTR, RD\n";
     std::cout << "Paddings: PKCS7, ANSI, ISO, Zeros\n";
 }
 Bytes prepareKey(const Bytes& rawKey, size_t size) {
@@ -32,8 +40,91 @@ Bytes prepareKey(const Bytes& rawKey, size_t size) {
 Bytes generateIV(size_t size) {
     return Bytes(size, Byte{0});
 }
+std::unique_ptr<IPadding> makePadding(const std::string& padStr) {
+    if (padStr == "PKCS7") return std::make_unique<padding::PKCS7>();
+    if (padStr == "ANSI") return std::make_unique<padding::ANSIX923>();
+    if (padStr == "ISO") return std::make_unique<padding::ISO10126>();
+    if (padStr == "Zeros") return std::make_unique<padding::Zeros>();
+    if (padStr == "None") return nullptr;
+    throw std::invalid_argument("Unknown padding");
+}
+Bytes deriveKey(const Bytes& key, std::string_view label) {
+    return modes::CMAC::deriveKey(std::make_unique<symmetric::FROG>(key), label, key.size());
+}
+std::unique_ptr<ICipherMode> makeMode(const std::string& modeStr, std::unique_ptr<IBlockCipher> cipher,
+                                      std::unique_ptr<IBlockCipher> macCipher, const std::string& padStr) {
+    size_t bs = cipher->getBlockSize();
+    auto padding = makePadding(padStr);
+    if (modeStr == "ECB") return std::make_unique<modes::ECB>(std::move(cipher), std::move(padding));
+    if (modeStr == "CBC") return std::make_unique<modes::CBC>(std::move(cipher), std::move(padding), generateIV(bs));
+    if (modeStr == "CBC-CMAC") {
+        return std::make_unique<modes::AuthenticatedCBC>(std::move(cipher), std::move(macCipher), std::move(padding), generateIV(bs));
+    }
+    if (modeStr == "PCBC") {
+        if (!padding) throw std::invalid_argument("PCBC needs padding");
+        return std::make_unique<modes::PCBC>(std::move(cipher), std::move(padding), generateIV(bs));
+    }
+    if (modeStr == "CFB") return std::make_unique<modes::CFB>(std::move(cipher), std::move(padding), generateIV(bs));
+    if (modeStr == "CFB8") return std::make_unique<modes::CFB>(std::move(cipher), std::move(padding), generateIV(bs), 1);
+    if (modeStr == "OFB") return std::make_unique<modes::OFB>(std::move(cipher), generateIV(bs));
+    if (modeStr == "CTR") return std::make_unique<modes::CTR>(std::move(cipher), generateIV(bs));
+    if (modeStr == "RD") return std::make_unique<modes::RandomDelta>(std::move(cipher), std::move(padding), generateIV(4));
+    throw std::invalid_argument("Unknown mode");
+}
+Bytes toKey(const std::string& keyStr) {
+    Bytes rawKey;
+    for(char c : keyStr) rawKey.push_back(static_cast<Byte>(c));
+    return prepareKey(rawKey, 16);
+}
+void validateModeArgs(const utils::BatchProcessor::ModeFactory& factory) {
+    if (!factory()) throw std::runtime_error("Mode factory returned no mode");
+}
+int runBatch(int argc, char* argv[]) {
+    if (argc != 8 && argc != 9) {
+        printUsage();
+        return 1;
+    }
+    std::string modeStr = argv[2];
+    std::string padStr = argv[3];
+    Bytes key = toKey(argv[4]);
+    std::filesystem::path input = argv[5];
+    std::filesystem::path outputDir = argv[6];
+    std::string operation = argv[7];
+    if (operation != "enc" && operation != "dec") {
+        printUsage();
+        return 1;
+    }
+    bool encrypt = operation == "enc";
+    std::shared_ptr<IBlockCipher> macCipher;
+    if (modeStr == "CBC-CMAC") {
+        macCipher = std::make_shared<symmetric::FROG>(deriveKey(key, "lab6 CBC-CMAC authentication"));
+        key = deriveKey(key, "lab6 CBC-CMAC encryption");
+    }
+    std::shared_ptr<IBlockCipher> cipher = std::make_shared<symmetric::FROG>(key);
+    utils::BatchProcessor::ModeFactory factory = [&] {
+        return makeMode(modeStr, std::make_unique<symmetric::SharedCipher>(cipher),
+                        macCipher ? std::make_unique<symmetric::SharedCipher>(macCipher) : nullptr, padStr);
+    };
+    validateModeArgs(factory);
+    auto jobs = std::filesystem::is_directory(input)
+        ? utils::BatchProcessor::scanDirectory(input, outputDir)
+        : utils::BatchProcessor::readManifest(input, outputDir);
+    std::cout << "Running FROG " << modeStr << " over " << jobs.size() << " files...\n";
+    auto results = utils::BatchProcessor::run(jobs, factory, encrypt);
+    if (argc == 9) {
+        std::ofstream report(argv[8]);
+        if (!report) throw std::runtime_error("Cannot open report file");
+        utils::BatchProcessor::writeReport(results, report);
+    } else {
+        utils::BatchProcessor::writeReport(results, std::cout);
+    }
+    auto failed = std::count_if(results.begin(), results.end(), [](const auto& r) { return !r.ok; });
+    std::cout << (results.size() - failed) << " succeeded, " << failed << " failed\n";
+    return failed == 0 ? 0 : 2;
+}
 int main(int argc, char* argv[]) {
     try {
+        if (argc > 1 && std::string(argv[1]) == "batch") return runBatch(argc, argv);
         if (argc != 7) {
             printUsage();
             return 1;
@@ -44,43 +135,15 @@ int main(int argc, char* argv[]) {
         std::filesystem::path inFile = argv[4];
         std::filesystem::path outFile = argv[5];
         bool encrypt = (std::string(argv[6]) == "enc");
-        Bytes rawKey;
-        for(char c : keyStr) rawKey.push_back(static_cast<Byte>(c));
-        Bytes key = prepareKey(rawKey, 16);
-        auto cipher = std::make_unique<symmetric::FROG>(key);
-        size_t bs = cipher->getBlockSize();
-        std::unique_ptr<IPadding> padding;
-        if (padStr == "PKCS7") padding = std::make_unique<padding::PKCS7>();
-        else if (padStr == "ANSI") padding = std::make_unique<padding::ANSIX923>();
-        else if (padStr == "ISO") padding = std::make_unique<padding::ISO10126>();
-        else if (padStr == "Zeros") padding = std::make_unique<padding::Zeros>();
-        else if (padStr == "None") padding = nullptr;
-        else throw std::invalid_argument("Unknown padding");
-
-        std::unique_ptr<ICipherMode> mode;
-        if (modeStr == "ECB") {
-            mode = std::make_unique<modes::ECB>(std::move(cipher), std::move(padding));
-        } else if (modeStr == "CBC") {
-            mode = std::make_unique<modes::CBC>(std::move(cipher), std::move(padding), generateIV(bs));
-        } else if (modeStr == "PCBC") {
-
-            if(!padding) throw std::invalid_argument("PCBC needs padding");
-            mode = std::make_unique<modes::PCBC>(std::move(cipher), std::move(padding), generateIV(bs));
-        } else if (modeStr == "CFB") {
-
-            mode = std::make_unique<modes::CFB>(std::move(cipher), std::move(padding), generateIV(bs));
-        } else if (modeStr == "OFB") {
-
-            mode = std::make_unique<modes::OFB>(std::move(cipher), generateIV(bs));
-        } else if (modeStr == "CTR") {
-            mode = std::make_unique<modes::CTR>(std::move(cipher), generateIV(bs));
-        } else if (modeStr == "RD") {
-            mode = std::make_unique<modes::RandomDelta>(std::move(cipher), std::move(padding), generateIV(4));
-        } else {
-            throw std::invalid_argument("Unknown mode");
+        Bytes key = toKey(keyStr);
+        std::unique_ptr<IBlockCipher> macCipher;
+        if (modeStr == "CBC-CMAC") {
+            macCipher = std::make_unique<symmetric::FROG>(deriveKey(key, "lab6 CBC-CMAC authentication"));
+            key = deriveKey(key, "lab6 CBC-CMAC encryption");
         }
-        std::cout << "Running FROG " << modeStr << "...\n";
-        utils::FileProcessor::process(inFile, outFile, *mode, encrypt);
+        auto mode = makeMode(modeStr, std::make_unique<symmetric::FROG>(key), std::move(macCipher), padStr);
+        std::cout << "Running FROG " << modeStr << " (" << utils::CpuFeatures::toString(utils::CpuFeatures::active()) << ")...\n";
+        utils::FileProcessor::process(inFile, outFile, *mode, encrypt, utils::FileProcessor::Backend::MemoryMapped);
         std::cout << "Done.\n";
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << "\n";
@@ -9,5 +9,17 @@ namespace crypto {
         [[nodiscard]] virtual size_t getKeySize() const = 0;
         virtual void encryptBlock(ConstBytesSpan src, BytesSpan dst) = 0;
         virtual void decryptBlock(ConstBytesSpan src, BytesSpan dst) = 0;
+        virtual void encryptBlocks(ConstBytesSpan src, BytesSpan dst, size_t nBlocks) {
+            size_t bs = getBlockSize();
+            for (size_t i = 0; i < nBlocks; ++i) {
+                encryptBlock(src.subspan(i * bs, bs), dst.subspan(i * bs, bs));
+            }
+        }
+        virtual void decryptBlocks(ConstBytesSpan src, BytesSpan dst, size_t nBlocks) {
+            size_t bs = getBlockSize();
+            for (size_t i = 0; i < nBlocks; ++i) {
+                decryptBlock(src.subspan(i * bs, bs), dst.subspan(i * bs, bs));
+            }
+        }
     };
 }
\ No newline at end of file
@@ -1,17 +1,164 @@
 #pragma once
 #include "crypto/interfaces/IBlockCipher.hpp"
 #include "crypto/interfaces/IPadding.hpp"
+#include "crypto/utils/Scheduler.hpp"
+#include <algorithm>
+#include <array>
 #include <memory>
+#include <stdexcept>
 namespace crypto {
     class ICipherMode {
     protected:
         std::unique_ptr<IBlockCipher> cipher;
         std::unique_ptr<IPadding> padding;
+        utils::ScheduleOptions schedule;
+        static constexpr size_t BATCH_BLOCKS = 1024;
+        static constexpr size_t MAX_BLOCK_SIZE = 64;
+        using Block = std::array<Byte, MAX_BLOCK_SIZE>;
+        virtual void resetChain() = 0;
+        virtual void encryptChunk(ConstBytesSpan input, BytesSpan output) = 0;
+        virtual void decryptChunk(ConstBytesSpan input, BytesSpan output) = 0;
+        [[nodiscard]] virtual bool allowsPartialBlock() const { return false; }
+        virtual void writeTag(BytesSpan) {}
+        virtual void verifyTag() {}
+    private:
+        Block pending{};
+        size_t pendingSize = 0;
+        bool encrypting = true;
+        void processChunk(ConstBytesSpan input, BytesSpan output) {
+            if (encrypting) encryptChunk(input, output);
+            else decryptChunk(input, output);
+        }
+        size_t finishPending(BytesSpan output) {
+            size_t bs = cipher->getBlockSize();
+            size_t used = pendingSize;
+            pendingSize = 0;
+            if (encrypting && padding) {
+                if (padding->paddedSize(used, bs) == 0) return 0;
+                if (output.size() < bs) throw std::invalid_argument("Output buffer too small");
+                padding->padBlock(std::span{pending.data(), bs}, used);
+                encryptChunk(std::span{pending.data(), bs}, output.first(bs));
+                return bs;
+            }
+            if (!encrypting && padding) {
+                if (used == 0) {
+                    verifyTag();
+                    if (padding->paddedSize(0, bs) > 0) throw std::runtime_error("Invalid padding: empty ciphertext");
+                    return 0;
+                }
+                if (used != bs) throw std::invalid_argument("Ciphertext is not a multiple of the block size");
+                Block plain;
+                decryptChunk(std::span{pending.data(), bs}, std::span{plain.data(), bs});
+                verifyTag();
+                size_t length = padding->removePadding(std::span{plain.data(), bs}, bs);
+                if (output.size() < length) throw std::invalid_argument("Output buffer too small");
+                std::copy_n(plain.begin(), length, output.begin());
+                return length;
+            }
+            if (used > 0) {
+                if (!allowsPartialBlock()) throw std::invalid_argument("Input is not a multiple of the block size");
+                if (output.size() < used) throw std::invalid_argument("Output buffer too small");
+                processChunk(std::span{pending.data(), used}, output.first(used));
+            }
+            if (!encrypting) verifyTag();
+            return used;
+        }
     public:
         ICipherMode(std::unique_ptr<IBlockCipher> c, std::unique_ptr<IPadding> p)
-            : cipher(std::move(c)), padding(std::move(p)) {}
+            : cipher(std::move(c)), padding(std::move(p))
+        {
+            if (cipher->getBlockSize() > MAX_BLOCK_SIZE) throw std::invalid_argument("Block size too large");
+        }
         virtual ~ICipherMode() = default;
-        virtual Bytes encrypt(ConstBytesSpan data) = 0;
-        virtual Bytes decrypt(ConstBytesSpan data) = 0;
+        void setSchedule(const utils::ScheduleOptions& options) {
+            if (options.grainBlocks == 0) throw std::invalid_argument("Schedule grain must be at least one block");
+            schedule = options;
+        }
+        [[nodiscard]] const utils::ScheduleOptions& getSchedule() const {
+            return schedule;
+        }
+        [[nodiscard]] size_t blockSize() const {
+            return cipher->getBlockSize();
+        }
+        [[nodiscard]] virtual size_t tagSize() const {
+            return 0;
+        }
+        virtual void setExpectedTag(ConstBytesSpan) {
+            throw std::logic_error("Mode does not produce an authentication tag");
+        }
+        [[nodiscard]] size_t encryptedSize(size_t plainSize) const {
+            return (padding ? padding->paddedSize(plainSize, cipher->getBlockSize()) : plainSize) + tagSize();
+        }
+        void begin(bool encrypt) {
+            encrypting = encrypt;
+            pendingSize = 0;
+            resetChain();
+        }
+        size_t update(ConstBytesSpan chunk, BytesSpan output) {
+            size_t bs = cipher->getBlockSize();
+            bool holdBack = !encrypting && padding;
+            size_t produced = 0;
+            if (pendingSize > 0) {
+                size_t take = std::min(bs - pendingSize, chunk.size());
+                std::copy_n(chunk.begin(), take, pending.begin() + pendingSize);
+                pendingSize += take;
+                chunk = chunk.subspan(take);
+                if (pendingSize == bs && (!holdBack || !chunk.empty())) {
+                    if (output.size() < bs) throw std::invalid_argument("Output buffer too small");
+                    processChunk(std::span{pending.data(), bs}, output.first(bs));
+                    produced = bs;
+                    pendingSize = 0;
+                }
+            }
+            if (pendingSize > 0) return produced;
+            size_t full = chunk.size() / bs * bs;
+            if (holdBack && full > 0 && full == chunk.size()) full -= bs;
+            if (output.size() < produced + full) throw std::invalid_argument("Output buffer too small");
+            if (full > 0) processChunk(chunk.first(full), output.subspan(produced, full));
+            pendingSize = chunk.size() - full;
+            std::copy(chunk.begin() + full, chunk.end(), pending.begin());
+            return produced + full;
+        }
+        size_t finalize(BytesSpan output) {
+            size_t produced = finishPending(output);
+            size_t tag = tagSize();
+            if (!encrypting || tag == 0) return produced;
+            if (output.size() < produced + tag) throw std::invalid_argument("Output buffer too small");
+            writeTag(output.subspan(produced, tag));
+            return produced + tag;
+        }
+        size_t encrypt(ConstBytesSpan input, BytesSpan output) {
+            if (output.size() < encryptedSize(input.size())) throw std::invalid_argument("Output buffer too small");
+            begin(true);
+            size_t produced = update(input, output);
+            return produced + finalize(output.subspan(produced));
+        }
+        size_t decrypt(ConstBytesSpan input, BytesSpan output) {
+            if (output.size() < input.size()) throw std::invalid_argument("Output buffer too small");
+            begin(false);
+            if (size_t tag = tagSize(); tag > 0) {
+                if (input.size() < tag) throw std::invalid_argument("Ciphertext shorter than the authentication tag");
+                setExpectedTag(input.last(tag));
+                input = input.first(input.size() - tag);
+            }
+            size_t produced = update(input, output);
+            return produced + finalize(output.subspan(produced));
+        }
+        Bytes encrypt(ConstBytesSpan input) {
+            Bytes result(encryptedSize(input.size()));
+            result.resize(encrypt(input, result));
+            return result;
+        }
+        Bytes decrypt(ConstBytesSpan input) {
+            Bytes result(input.size());
+            result.resize(decrypt(input, result));
+            return result;
+        }
+        size_t encryptInPlace(BytesSpan buffer, size_t length) {
+            return encrypt(buffer.first(length), buffer);
+        }
+        size_t decryptInPlace(BytesSpan buffer) {
+            return decrypt(buffer, buffer);
+        }
     };
 }
\ No newline at end of file
@@ -1,10 +1,19 @@
 #pragma once
 #include "crypto/common/types.hpp"
+#include <algorithm>
 namespace crypto {
     class IPadding {
     public:
         virtual ~IPadding() = default;
         virtual void addPadding(Bytes& data, size_t blockSize) = 0;
         virtual size_t removePadding(ConstBytesSpan data, size_t blockSize) = 0;
+        [[nodiscard]] virtual size_t paddedSize(size_t dataSize, size_t blockSize) const {
+            return (dataSize / blockSize + 1) * blockSize;
+        }
+        virtual void padBlock(BytesSpan block, size_t used) {
+            Bytes tail(block.begin(), block.begin() + used);
+            addPadding(tail, block.size());
+            std::copy_n(tail.begin(), block.size(), block.begin());
+        }
     };
 }
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+#include "crypto/modes/CBC.hpp"
+#include "crypto/modes/CMAC.hpp"
+namespace crypto::modes {
+    class AuthenticatedCBC : public CBC {
+        CMAC mac;
+        Block expected{};
+        bool haveExpected = false;
+    protected:
+        void resetChain() override {
+            CBC::resetChain();
+            mac.reset();
+            haveExpected = false;
+        }
+        void encryptChunk(ConstBytesSpan input, BytesSpan output) override {
+            size_t bs = cipher->getBlockSize();
+            for (size_t offset = 0; offset < input.size(); offset += bs) {
+                BytesSpan out = output.subspan(offset, bs);
+                CBC::encryptChunk(input.subspan(offset, bs), out);
+                mac.update(out);
+            }
+        }
+        void decryptChunk(ConstBytesSpan input, BytesSpan output) override {
+            mac.update(input);
+            CBC::decryptChunk(input, output);
+        }
+        void writeTag(BytesSpan tag) override {
+            mac.finalize(tag);
+        }
+        void verifyTag() override {
+            if (!haveExpected) throw std::logic_error("Expected authentication tag was not supplied");
+            Block actual;
+            mac.finalize(std::span{actual.data(), mac.tagSize()});
+            Byte diff{0};
+            for (size_t i = 0; i < mac.tagSize(); ++i) diff |= actual[i] ^ expected[i];
+            if (diff != Byte{0}) throw std::runtime_error("Authentication tag mismatch");
+        }
+    public:
+        AuthenticatedCBC(std::unique_ptr<IBlockCipher> c, std::unique_ptr<IBlockCipher> macCipher,
+                         std::unique_ptr<IPadding> p, ConstBytesSpan iv_)
+            : CBC(std::move(c), std::move(p), iv_), mac(std::move(macCipher))
+        {
+            if (mac.tagSize() != cipher->getBlockSize()) throw std::invalid_argument("MAC cipher block size mismatch");
+        }
+        [[nodiscard]] size_t tagSize() const override {
+            return mac.tagSize();
+        }
+        void setExpectedTag(ConstBytesSpan tag) override {
+            if (tag.size() != mac.tagSize()) throw std::invalid_argument("Invalid authentication tag size");
+            utils::BlockOps::copy(expected, tag);
+            haveExpected = true;
+        }
+    };
+}
\ No newline at end of file
@@ -1,51 +1,54 @@
 #pragma once
 #include "crypto/interfaces/ICipherMode.hpp"
+#include "crypto/utils/BlockOps.hpp"
 #include <vector>
 namespace crypto::modes {
-    class CBC : public ICipherMode {
+    template<typename Cipher = IBlockCipher>
+    class BasicCBC : public ICipherMode {
         Bytes iv;
-    public:
-        CBC(std::unique_ptr<IBlockCipher> c, std::unique_ptr<IPadding> p, ConstBytesSpan iv_)
-            : ICipherMode(std::move(c), std::move(p)), iv(iv_.begin(), iv_.end())
-        {
-            if (iv.size() != cipher->getBlockSize()) throw std::invalid_argument("Invalid IV size");
+        Bytes chain;
+        Cipher& blockCipher() const {
+            return static_cast<Cipher&>(*cipher);
+        }
+    protected:
+        void resetChain() override {
+            chain = iv;
         }
-        Bytes encrypt(ConstBytesSpan input) override {
-            Bytes data(input.begin(), input.end());
-            size_t bs = cipher->getBlockSize();
-            padding->addPadding(data, bs);
-            Bytes result(data.size());
-            size_t blockCount = data.size() / bs;
-            Bytes prevBlock = iv;
-            for(size_t i = 0; i < blockCount; ++i) {
-                size_t offset = i * bs;
-                Bytes block(bs);
-                for(size_t j = 0; j < bs; ++j) {
-                    block[j] = data[offset + j] ^ prevBlock[j];
-                }
-                cipher->encryptBlock(block, std::span{result.data() + offset, bs});
-                std::copy(result.begin() + offset, result.begin() + offset + bs, prevBlock.begin());
+        void encryptChunk(ConstBytesSpan input, BytesSpan output) override {
+            size_t bs = blockCipher().getBlockSize();
+            for (size_t offset = 0; offset < input.size(); offset += bs) {
+                BytesSpan out = output.subspan(offset, bs);
+                utils::BlockOps::xorInto(chain, input.subspan(offset, bs));
+                blockCipher().encryptBlock(chain, out);
+                utils::BlockOps::copy(chain, out);
             }
-            return result;
         }
-        Bytes decrypt(ConstBytesSpan input) override {
-            size_t bs = cipher->getBlockSize();
-            if (input.size() % bs != 0) throw std::invalid_argument("Bad size");
-            Bytes result(input.size());
+        void decryptChunk(ConstBytesSpan input, BytesSpan output) override {
+            size_t bs = blockCipher().getBlockSize();
             size_t blockCount = input.size() / bs;
-            std::vector<size_t> indices(blockCount);
-            std::iota(indices.begin(), indices.end(), 0);
-            std::for_each(std::execution::par, indices.begin(), indices.end(), [&](size_t i) {
-                size_t offset = i * bs;
-                cipher->decryptBlock(input.subspan(offset, bs), std::span{result.data() + offset, bs});
-                ConstBytesSpan xorBlock = (i == 0) ? std::span{iv} : input.subspan(offset - bs, bs);
-                for(size_t j=0; j<bs; ++j) {
-                    result[offset + j] ^= xorBlock[j];
-                }
+            size_t grain = std::max<size_t>(schedule.grainBlocks, 1);
+            size_t chunkCount = (blockCount + grain - 1) / grain;
+            Bytes chains(chunkCount * bs);
+            for (size_t c = 0; c < chunkCount; ++c) {
+                ConstBytesSpan prev = (c == 0) ? std::span{chain} : input.subspan((c * grain - 1) * bs, bs);
+                utils::BlockOps::copy(std::span{chains}.subspan(c * bs, bs), prev);
+            }
+            utils::BlockOps::copy(chain, input.last(bs));
+            utils::Scheduler::forEachChunk(blockCount, schedule, [&](size_t c, size_t first, size_t count) {
+                Bytes plain(count * bs);
+                blockCipher().decryptBlocks(input.subspan(first * bs, count * bs), plain, count);
+                utils::BlockOps::xorInto(std::span{plain.data(), bs}, std::span{chains.data() + c * bs, bs});
+                utils::BlockOps::xorInto(std::span{plain.data() + bs, (count - 1) * bs},
+                                         input.subspan(first * bs, (count - 1) * bs));
+                utils::BlockOps::copy(output.subspan(first * bs, count * bs), plain);
             });
-            size_t validSize = padding->removePadding(result, bs);
-            result.resize(validSize);
-            return result;
+        }
+    public:
+        BasicCBC(std::unique_ptr<Cipher> c, std::unique_ptr<IPadding> p, ConstBytesSpan iv_)
+            : ICipherMode(std::move(c), std::move(p)), iv(iv_.begin(), iv_.end())
+        {
+            if (iv.size() != cipher->getBlockSize()) throw std::invalid_argument("Invalid IV size");
         }
     };
+    using CBC = BasicCBC<>;
 }
\ No newline at end of file
@@ -1,53 +1,84 @@
 #pragma once
 #include "crypto/interfaces/ICipherMode.hpp"
+#include "crypto/utils/BlockOps.hpp"
 namespace crypto::modes {
     class CFB : public ICipherMode {
         Bytes iv;
-    public:
-
-
-
-        CFB(std::unique_ptr<IBlockCipher> c, std::unique_ptr<IPadding> p, ConstBytesSpan iv_)
-            : ICipherMode(std::move(c), std::move(p)), iv(iv_.begin(), iv_.end()) {}
-        Bytes encrypt(ConstBytesSpan input) override {
-            Bytes data(input.begin(), input.end());
+        Bytes feedback;
+        size_t segment;
+        void shiftFeedback(ConstBytesSpan ciphertext) {
+            size_t bs = feedback.size();
+            size_t len = ciphertext.size();
+            utils::BlockOps::copy(feedback, std::span{feedback}.subspan(len));
+            utils::BlockOps::copy(std::span{feedback}.subspan(bs - len), ciphertext);
+        }
+    protected:
+        void resetChain() override {
+            feedback = iv;
+        }
+        void encryptChunk(ConstBytesSpan input, BytesSpan output) override {
             size_t bs = cipher->getBlockSize();
-            if (padding) padding->addPadding(data, bs);
-            Bytes result(data.size());
-            Bytes feedback = iv;
-            for (size_t i = 0; i < data.size(); i += bs) {
-
-                Bytes output(bs);
-                cipher->encryptBlock(feedback, output);
-                size_t len = std::min(bs, data.size() - i);
-                for (size_t j = 0; j < len; ++j) {
-                    result[i + j] = data[i + j] ^ output[j];
-
-                    if (j < bs) feedback[j] = result[i + j];
-                }
+            Block keystreamBlock;
+            BytesSpan keystream = std::span{keystreamBlock.data(), bs};
+            for (size_t offset = 0; offset < input.size(); offset += segment) {
+                size_t len = std::min(segment, input.size() - offset);
+                cipher->encryptBlock(feedback, keystream);
+                BytesSpan out = output.subspan(offset, len);
+                utils::BlockOps::xor3(out, keystream, input.subspan(offset, len));
+                shiftFeedback(out);
             }
-            return result;
         }
-        Bytes decrypt(ConstBytesSpan input) override {
-            Bytes result(input.size());
+        void decryptChunk(ConstBytesSpan input, BytesSpan output) override {
             size_t bs = cipher->getBlockSize();
-            Bytes feedback = iv;
-            for (size_t i = 0; i < input.size(); i += bs) {
-                Bytes output(bs);
-                cipher->encryptBlock(feedback, output);
-                size_t len = std::min(bs, input.size() - i);
-                for (size_t j = 0; j < len; ++j) {
-                    Byte c = input[i + j];
-                    result[i + j] = c ^ output[j];
-
-                    if (j < bs) feedback[j] = c;
+            size_t segmentCount = (input.size() + segment - 1) / segment;
+            size_t grain = std::max<size_t>(schedule.grainBlocks, 1);
+            size_t chunkCount = (segmentCount + grain - 1) / grain;
+            Bytes heads(chunkCount * bs);
+            for (size_t c = 0; c < chunkCount; ++c) {
+                size_t start = c * grain * segment;
+                Byte* head = heads.data() + c * bs;
+                if (start >= bs) {
+                    utils::BlockOps::copy(std::span{head, bs}, input.subspan(start - bs, bs));
+                } else {
+                    utils::BlockOps::copy(std::span{head, bs}, std::span{feedback}.subspan(start));
+                    utils::BlockOps::copy(std::span{head + (bs - start), start}, input.first(start));
                 }
             }
-            if (padding) {
-                size_t valid = padding->removePadding(result, bs);
-                result.resize(valid);
-            }
-            return result;
+            shiftFeedback(input.last(std::min(bs, input.size())));
+            utils::Scheduler::forEachChunk(segmentCount, schedule, [&](size_t c, size_t first, size_t count) {
+                const Byte* head = heads.data() + c * bs;
+                ConstBytesSpan chunk = input.subspan(first * segment, std::min(count * segment, input.size() - first * segment));
+                Bytes keystream(count * bs);
+                for (size_t k = 0; k < count; ++k) {
+                    size_t start = k * segment;
+                    Byte* dst = keystream.data() + k * bs;
+                    if (start >= bs) {
+                        utils::BlockOps::copy(std::span{dst, bs}, chunk.subspan(start - bs, bs));
+                    } else {
+                        utils::BlockOps::copy(std::span{dst, bs}, std::span{head + start, bs - start});
+                        utils::BlockOps::copy(std::span{dst + (bs - start), start}, chunk.first(start));
+                    }
+                }
+                cipher->encryptBlocks(keystream, keystream, count);
+                if (segment != bs) {
+                    for (size_t k = 1; k < count; ++k) {
+                        utils::BlockOps::copy(std::span{keystream}.subspan(k * segment, segment), std::span{keystream}.subspan(k * bs, segment));
+                    }
+                }
+                utils::BlockOps::xor3(output.subspan(first * segment, chunk.size()), keystream, chunk);
+            });
+        }
+        [[nodiscard]] bool allowsPartialBlock() const override { return !padding; }
+    public:
+        CFB(std::unique_ptr<IBlockCipher> c, std::unique_ptr<IPadding> p, ConstBytesSpan iv_, size_t segmentSize = 0)
+            : ICipherMode(std::move(c), std::move(p)), iv(iv_.begin(), iv_.end()),
+              segment(segmentSize == 0 ? cipher->getBlockSize() : segmentSize)
+        {
+            if (iv.size() != cipher->getBlockSize()) throw std::invalid_argument("Invalid IV size");
+            if (cipher->getBlockSize() % segment != 0) throw std::invalid_argument("CFB segment size must divide the block size");
+        }
+        [[nodiscard]] size_t segmentSize() const {
+            return segment;
         }
     };
 }
\ No newline at end of file
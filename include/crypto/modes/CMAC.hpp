@@ -0,0 +1,90 @@
+#pragma once
+#include "crypto/interfaces/IBlockCipher.hpp"
+#include "crypto/utils/BlockOps.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+namespace crypto::modes {
+    class CMAC {
+        static constexpr size_t MAX_BLOCK_SIZE = 64;
+        using Block = std::array<Byte, MAX_BLOCK_SIZE>;
+        std::unique_ptr<IBlockCipher> cipher;
+        size_t bs;
+        Block k1{}, k2{}, state{}, last{};
+        bool haveLast = false;
+        void doubleSubkey(const Block& in, Block& out) const {
+            Byte reduction = bs == 8 ? Byte{0x1B} : Byte{0x87};
+            Byte carry{0};
+            for (size_t i = bs; i-- > 0;) {
+                out[i] = (in[i] << 1) | carry;
+                carry = in[i] >> 7;
+            }
+            if (carry != Byte{0}) out[bs - 1] ^= reduction;
+        }
+        void absorb(ConstBytesSpan block) {
+            BytesSpan x = std::span{state.data(), bs};
+            utils::BlockOps::xorInto(x, block);
+            cipher->encryptBlock(x, x);
+        }
+    public:
+        explicit CMAC(std::unique_ptr<IBlockCipher> c) : cipher(std::move(c)), bs(cipher->getBlockSize()) {
+            if (bs != 8 && bs != 16) throw std::invalid_argument("CMAC supports 64- and 128-bit blocks only");
+            Block zero{}, l{};
+            cipher->encryptBlock(std::span{zero.data(), bs}, std::span{l.data(), bs});
+            doubleSubkey(l, k1);
+            doubleSubkey(k1, k2);
+        }
+        [[nodiscard]] size_t tagSize() const {
+            return bs;
+        }
+        void reset() {
+            state.fill(Byte{0});
+            haveLast = false;
+        }
+        void update(ConstBytesSpan data) {
+            if (data.size() % bs != 0) throw std::invalid_argument("CMAC input must be whole blocks");
+            for (size_t offset = 0; offset < data.size(); offset += bs) {
+                if (haveLast) absorb(std::span{last.data(), bs});
+                utils::BlockOps::copy(std::span{last.data(), bs}, data.subspan(offset, bs));
+                haveLast = true;
+            }
+        }
+        void finalize(BytesSpan tag) {
+            if (tag.size() < bs) throw std::invalid_argument("Tag buffer too small");
+            Block final{};
+            if (haveLast) {
+                utils::BlockOps::xor3(std::span{final.data(), bs}, std::span{last.data(), bs}, std::span{k1.data(), bs});
+            } else {
+                final[0] = Byte{0x80};
+                utils::BlockOps::xorInto(std::span{final.data(), bs}, std::span{k2.data(), bs});
+            }
+            absorb(std::span{final.data(), bs});
+            utils::BlockOps::copy(tag, std::span{state.data(), bs});
+        }
+        static Bytes deriveKey(std::unique_ptr<IBlockCipher> prf, std::string_view label, size_t length) {
+            CMAC mac(std::move(prf));
+            size_t bs = mac.tagSize();
+            if (length == 0 || length > 255 * bs) throw std::invalid_argument("Derived key length out of range");
+            auto bits = static_cast<uint32_t>(length * 8);
+            Bytes key, message;
+            key.reserve(length);
+            Block tag{};
+            for (size_t counter = 1; key.size() < length; ++counter) {
+                message.assign(1, static_cast<Byte>(counter));
+                for (char c : label) message.push_back(static_cast<Byte>(c));
+                message.push_back(Byte{0});
+                for (int shift = 24; shift >= 0; shift -= 8) message.push_back(static_cast<Byte>(bits >> shift));
+                message.push_back(Byte{0x80});
+                message.resize((message.size() + bs - 1) / bs * bs, Byte{0});
+                mac.reset();
+                mac.update(message);
+                mac.finalize(std::span{tag.data(), bs});
+                key.insert(key.end(), tag.begin(), tag.begin() + std::min(bs, length - key.size()));
+            }
+            return key;
+        }
+    };
+}
\ No newline at end of file
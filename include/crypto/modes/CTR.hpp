@@ -1,37 +1,75 @@
 #pragma once
 #include "crypto/interfaces/ICipherMode.hpp"
-#include "crypto/utils/BitUtils.hpp"
+#include "crypto/utils/BlockOps.hpp"
 namespace crypto::modes {
-    class CTR : public ICipherMode {
+    template<typename Cipher = IBlockCipher>
+    class BasicCTR : public ICipherMode {
         Bytes iv;
+        uint64_t position = 0;
+        Cipher& blockCipher() const {
+            return static_cast<Cipher&>(*cipher);
+        }
+        void counterBlock(uint64_t index, BytesSpan out) const {
+            unsigned carry = 0;
+            for (size_t i = iv.size(); i-- > 0;) {
+                unsigned sum = static_cast<unsigned>(iv[i]) + static_cast<unsigned>(index & 0xFF) + carry;
+                out[i] = static_cast<Byte>(sum);
+                carry = sum >> 8;
+                index >>= 8;
+            }
+        }
+        static void increment(BytesSpan counter) {
+            for (size_t i = counter.size(); i-- > 0;) {
+                counter[i] = static_cast<Byte>(static_cast<unsigned>(counter[i]) + 1);
+                if (counter[i] != Byte{0}) break;
+            }
+        }
+        void crypt(uint64_t offset, ConstBytesSpan input, BytesSpan output) {
+            if (input.empty()) return;
+            size_t bs = blockCipher().getBlockSize();
+            uint64_t firstBlock = offset / bs;
+            size_t skip = offset % bs;
+            size_t blockCount = (skip + input.size() + bs - 1) / bs;
+            utils::Scheduler::forEachChunk(blockCount, schedule, [&](size_t, size_t first, size_t count) {
+                Bytes keystream(count * bs);
+                counterBlock(firstBlock + first, std::span{keystream.data(), bs});
+                for (size_t i = 1; i < count; ++i) {
+                    utils::BlockOps::copy(std::span{keystream}.subspan(i * bs, bs), std::span{keystream}.subspan((i - 1) * bs, bs));
+                    increment(std::span{keystream.data() + i * bs, bs});
+                }
+                blockCipher().encryptBlocks(keystream, keystream, count);
+                size_t lo = std::max(first * bs, skip);
+                size_t hi = std::min((first + count) * bs, skip + input.size());
+                utils::BlockOps::xor3(output.subspan(lo - skip, hi - lo), std::span{keystream}.subspan(lo - first * bs),
+                                      input.subspan(lo - skip, hi - lo));
+            });
+        }
+        void process(ConstBytesSpan input, BytesSpan output) {
+            crypt(position, input, output);
+            position += input.size();
+        }
+    protected:
+        void resetChain() override {
+            position = 0;
+        }
+        void encryptChunk(ConstBytesSpan input, BytesSpan output) override { process(input, output); }
+        void decryptChunk(ConstBytesSpan input, BytesSpan output) override { process(input, output); }
+        [[nodiscard]] bool allowsPartialBlock() const override { return true; }
     public:
-        CTR(std::unique_ptr<IBlockCipher> c, ConstBytesSpan iv_)
+        BasicCTR(std::unique_ptr<Cipher> c, ConstBytesSpan iv_)
             : ICipherMode(std::move(c), nullptr), iv(iv_.begin(), iv_.end())
         {
              if (iv.size() != cipher->getBlockSize()) throw std::invalid_argument("IV size mismatch");
         }
-        Bytes process(ConstBytesSpan input) {
-            Bytes result(input.begin(), input.end());
-            size_t bs = cipher->getBlockSize();
-            size_t blockCount = (input.size() + bs - 1) / bs;
-            std::vector<size_t> indices(blockCount);
-            std::iota(indices.begin(), indices.end(), 0);
-            std::for_each(std::execution::par, indices.begin(), indices.end(), [&](size_t i) {
-                uint64_t counterVal = utils::BitUtils::bytesToUInt64(iv);
-                counterVal += i;
-                Bytes ctrBlock(bs);
-                utils::BitUtils::uint64ToBytes(counterVal, ctrBlock);
-                Bytes encryptedCtr(bs);
-                cipher->encryptBlock(ctrBlock, encryptedCtr);
-                size_t offset = i * bs;
-                size_t len = std::min(bs, result.size() - offset);
-                for(size_t j=0; j<len; ++j) {
-                    result[offset + j] ^= encryptedCtr[j];
-                }
-            });
-            return result;
+        void seek(uint64_t offset) {
+            begin(true);
+            position = offset;
+        }
+        size_t processRange(uint64_t offset, ConstBytesSpan input, BytesSpan output) {
+            if (output.size() < input.size()) throw std::invalid_argument("Output buffer too small");
+            crypt(offset, input, output);
+            return input.size();
         }
-        Bytes encrypt(ConstBytesSpan input) override { return process(input); }
-        Bytes decrypt(ConstBytesSpan input) override { return process(input); }
     };
+    using CTR = BasicCTR<>;
 }
\ No newline at end of file
@@ -1,48 +1,35 @@
 #pragma once
 #include "crypto/interfaces/ICipherMode.hpp"
-#include <execution>
 #include <algorithm>
 #include <stdexcept>
 namespace crypto::modes {
-    class ECB : public ICipherMode {
-    public:
-        using ICipherMode::ICipherMode;
-        Bytes encrypt(ConstBytesSpan input) override {
-            Bytes data(input.begin(), input.end());
-            size_t bs = cipher->getBlockSize();
-            padding->addPadding(data, bs);
-            Bytes result(data.size());
-            size_t blockCount = data.size() / bs;
-            std::vector<size_t> indices(blockCount);
-            std::iota(indices.begin(), indices.end(), 0);
-            std::for_each(std::execution::par, indices.begin(), indices.end(),
-                [&](size_t i) {
-                    size_t offset = i * bs;
-                    cipher->encryptBlock(
-                        std::span{data.data() + offset, bs},
-                        std::span{result.data() + offset, bs}
-                    );
-                });
-            return result;
+    template<typename Cipher = IBlockCipher>
+    class BasicECB : public ICipherMode {
+        Cipher& blockCipher() const {
+            return static_cast<Cipher&>(*cipher);
+        }
+        template<typename Op>
+        void forEachBatch(ConstBytesSpan input, BytesSpan output, Op op) {
+            size_t bs = blockCipher().getBlockSize();
+            utils::Scheduler::forEachChunk(input.size() / bs, schedule, [&](size_t, size_t first, size_t count) {
+                op(input.subspan(first * bs, count * bs), output.subspan(first * bs, count * bs), count);
+            });
         }
-        Bytes decrypt(ConstBytesSpan input) override {
-             size_t bs = cipher->getBlockSize();
-             if (input.size() % bs != 0) throw std::invalid_argument("Invalid data size for decryption");
-             Bytes result(input.size());
-             size_t blockCount = input.size() / bs;
-             std::vector<size_t> indices(blockCount);
-             std::iota(indices.begin(), indices.end(), 0);
-             std::for_each(std::execution::par, indices.begin(), indices.end(),
-                [&](size_t i) {
-                    size_t offset = i * bs;
-                    cipher->decryptBlock(
-                        input.subspan(offset, bs),
-                        std::span{result.data() + offset, bs}
-                    );
-                });
-             size_t validSize = padding->removePadding(result, bs);
-             result.resize(validSize);
-             return result;
+    protected:
+        void resetChain() override {}
+        void encryptChunk(ConstBytesSpan input, BytesSpan output) override {
+            forEachBatch(input, output, [&](ConstBytesSpan src, BytesSpan dst, size_t count) {
+                blockCipher().encryptBlocks(src, dst, count);
+            });
         }
+        void decryptChunk(ConstBytesSpan input, BytesSpan output) override {
+            forEachBatch(input, output, [&](ConstBytesSpan src, BytesSpan dst, size_t count) {
+                blockCipher().decryptBlocks(src, dst, count);
+            });
+        }
+    public:
+        BasicECB(std::unique_ptr<Cipher> c, std::unique_ptr<IPadding> p)
+            : ICipherMode(std::move(c), std::move(p)) {}
     };
+    using ECB = BasicECB<>;
 }
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+#include "crypto/modes/ECB.hpp"
+#include "crypto/modes/CBC.hpp"
+#include "crypto/modes/CTR.hpp"
+#include <type_traits>
+namespace crypto::modes {
+    template<typename Chaining>
+    struct ChainingTraits;
+    template<typename C>
+    struct ChainingTraits<BasicECB<C>> {
+        template<typename Cipher>
+        using Bind = BasicECB<Cipher>;
+    };
+    template<typename C>
+    struct ChainingTraits<BasicCBC<C>> {
+        template<typename Cipher>
+        using Bind = BasicCBC<Cipher>;
+    };
+    template<typename C>
+    struct ChainingTraits<BasicCTR<C>> {
+        template<typename Cipher>
+        using Bind = BasicCTR<Cipher>;
+    };
+    template<typename Chaining, typename Cipher, typename Padding = void>
+    class Mode final : public ChainingTraits<Chaining>::template Bind<Cipher> {
+        using Base = typename ChainingTraits<Chaining>::template Bind<Cipher>;
+        static_assert(std::is_final_v<Cipher>, "Composed modes need a final cipher type");
+        static_assert(std::is_void_v<Padding> || std::is_base_of_v<IPadding, Padding>, "Padding must implement IPadding");
+        static std::unique_ptr<IPadding> makePadding() {
+            if constexpr (std::is_void_v<Padding>) return nullptr;
+            else return std::make_unique<Padding>();
+        }
+    public:
+        template<typename... Args>
+            requires std::is_constructible_v<Base, std::unique_ptr<Cipher>, std::unique_ptr<IPadding>, Args&&...>
+        explicit Mode(ConstBytesSpan key, Args&&... args)
+            : Base(std::make_unique<Cipher>(key), makePadding(), std::forward<Args>(args)...) {}
+        template<typename... Args>
+            requires (std::is_void_v<Padding> && std::is_constructible_v<Base, std::unique_ptr<Cipher>, Args&&...>)
+        explicit Mode(ConstBytesSpan key, Args&&... args)
+            : Base(std::make_unique<Cipher>(key), std::forward<Args>(args)...) {}
+    };
+}
\ No newline at end of file
@@ -0,0 +1,23 @@
+#pragma once
+#include "crypto/interfaces/IBlockCipher.hpp"
+#include "crypto/interfaces/IPadding.hpp"
+#include <memory>
+#include <span>
+#include <vector>
+namespace crypto::modes {
+    class MultiBufferCBC {
+    public:
+        struct Stream {
+            IBlockCipher* cipher;
+            ConstBytesSpan iv;
+            ConstBytesSpan input;
+            BytesSpan output;
+        };
+        static constexpr size_t MAX_LANES = 1024;
+        explicit MultiBufferCBC(std::unique_ptr<IPadding> padding) : padding(std::move(padding)) {}
+        [[nodiscard]] size_t encryptedSize(size_t plainSize, size_t blockSize) const;
+        std::vector<size_t> encrypt(std::span<const Stream> streams);
+    private:
+        std::unique_ptr<IPadding> padding;
+    };
+}
\ No newline at end of file
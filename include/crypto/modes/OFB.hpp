@@ -1,31 +1,50 @@
 #pragma once
 #include "crypto/interfaces/ICipherMode.hpp"
+#include "crypto/utils/BlockOps.hpp"
+#include "crypto/utils/KeystreamRing.hpp"
 namespace crypto::modes {
     class OFB : public ICipherMode {
         Bytes iv;
-    public:
-        OFB(std::unique_ptr<IBlockCipher> c, ConstBytesSpan iv_)
-            : ICipherMode(std::move(c), nullptr), iv(iv_.begin(), iv_.end()) {}
-
-        Bytes process(ConstBytesSpan input) {
-            Bytes result(input.begin(), input.end());
+        Bytes state;
+        std::unique_ptr<utils::KeystreamRing> ring;
+        void generate(BytesSpan keystream) {
             size_t bs = cipher->getBlockSize();
-            Bytes currentIV = iv;
-            size_t blocks = (input.size() + bs - 1) / bs;
-
-            for (size_t i = 0; i < blocks; ++i) {
-                Bytes keystream(bs);
-                cipher->encryptBlock(currentIV, keystream);
-                currentIV = keystream;
-                size_t offset = i * bs;
+            ConstBytesSpan previous = state;
+            for (size_t offset = 0; offset < keystream.size(); offset += bs) {
+                BytesSpan block = keystream.subspan(offset, bs);
+                cipher->encryptBlock(previous, block);
+                previous = block;
+            }
+            utils::BlockOps::copy(state, previous);
+        }
+        void process(ConstBytesSpan input, BytesSpan output) {
+            if (!ring && input.size() >= PREFETCH_MIN_BYTES) {
+                ring = std::make_unique<utils::KeystreamRing>(cipher->getBlockSize() * SEGMENT_BLOCKS, SEGMENT_COUNT,
+                                                              [this](BytesSpan segment) { generate(segment); });
+            }
+            if (ring) return ring->apply(input, output);
+            size_t bs = cipher->getBlockSize();
+            Block keystreamBlock;
+            BytesSpan keystream = std::span{keystreamBlock.data(), bs};
+            for (size_t offset = 0; offset < input.size(); offset += bs) {
+                generate(keystream);
                 size_t len = std::min(bs, input.size() - offset);
-                for(size_t j=0; j < len; ++j) {
-                    result[offset + j] ^= keystream[j];
-                }
+                utils::BlockOps::xor3(output.subspan(offset, len), keystream, input.subspan(offset, len));
             }
-            return result;
         }
-        Bytes encrypt(ConstBytesSpan input) override { return process(input); }
-        Bytes decrypt(ConstBytesSpan input) override { return process(input); }
+    protected:
+        void resetChain() override {
+            ring.reset();
+            state = iv;
+        }
+        void encryptChunk(ConstBytesSpan input, BytesSpan output) override { process(input, output); }
+        void decryptChunk(ConstBytesSpan input, BytesSpan output) override { process(input, output); }
+        [[nodiscard]] bool allowsPartialBlock() const override { return true; }
+    public:
+        static constexpr size_t PREFETCH_MIN_BYTES = 64 << 10;
+        static constexpr size_t SEGMENT_BLOCKS = 4096;
+        static constexpr size_t SEGMENT_COUNT = 4;
+        OFB(std::unique_ptr<IBlockCipher> c, ConstBytesSpan iv_)
+            : ICipherMode(std::move(c), nullptr), iv(iv_.begin(), iv_.end()) {}
     };
 }
\ No newline at end of file
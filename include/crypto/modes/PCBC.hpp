@@ -1,69 +1,59 @@
 #pragma once
 #include "crypto/interfaces/ICipherMode.hpp"
+#include "crypto/utils/BlockOps.hpp"
+#include <algorithm>
 #include <vector>
 namespace crypto::modes {
     class PCBC : public ICipherMode {
         Bytes iv;
-    public:
-        PCBC(std::unique_ptr<IBlockCipher> c, std::unique_ptr<IPadding> p, ConstBytesSpan iv_)
-            : ICipherMode(std::move(c), std::move(p)), iv(iv_.begin(), iv_.end())
-        {
-            if (iv.size() != cipher->getBlockSize()) throw std::invalid_argument("Invalid IV size");
+        Bytes state;
+        Bytes links;
+    protected:
+        void resetChain() override {
+            state = iv;
         }
-        Bytes encrypt(ConstBytesSpan input) override {
-            Bytes data(input.begin(), input.end());
+        void encryptChunk(ConstBytesSpan input, BytesSpan output) override {
             size_t bs = cipher->getBlockSize();
-            padding->addPadding(data, bs);
-            Bytes result(data.size());
-            size_t blocks = data.size() / bs;
-            Bytes prevP = iv;
-            Bytes prevC(bs, Byte{0});
-
-
-
-
-
-            Bytes state = iv;
-            for(size_t i=0; i<blocks; ++i) {
-                size_t offset = i * bs;
-                Bytes block(bs);
-
-                for(size_t j=0; j<bs; ++j) {
-                    block[j] = data[offset + j] ^ state[j];
-                }
-
-                cipher->encryptBlock(block, std::span{result.data() + offset, bs});
-
-                for(size_t j=0; j<bs; ++j) {
-                    state[j] = data[offset + j] ^ result[offset + j];
-                }
+            Block plainBlock;
+            BytesSpan plain = std::span{plainBlock.data(), bs};
+            for (size_t offset = 0; offset < input.size(); offset += bs) {
+                BytesSpan out = output.subspan(offset, bs);
+                utils::BlockOps::copy(plain, input.subspan(offset, bs));
+                utils::BlockOps::xorInto(state, plain);
+                cipher->encryptBlock(state, out);
+                utils::BlockOps::xor3(state, out, plain);
             }
-            return result;
         }
-        Bytes decrypt(ConstBytesSpan input) override {
+        void decryptChunk(ConstBytesSpan input, BytesSpan output) override {
             size_t bs = cipher->getBlockSize();
-            if (input.size() % bs != 0) throw std::invalid_argument("Invalid size");
-            Bytes result(input.size());
-            size_t blocks = input.size() / bs;
-            Bytes state = iv;
-            for(size_t i=0; i<blocks; ++i) {
-                size_t offset = i * bs;
-
-                Bytes decBlock(bs);
-                cipher->decryptBlock(input.subspan(offset, bs), decBlock);
-
-                for(size_t j=0; j<bs; ++j) {
-                    result[offset + j] = decBlock[j] ^ state[j];
-                }
-
-
-                for(size_t j=0; j<bs; ++j) {
-                    state[j] = result[offset + j] ^ input[offset + j];
-                }
+            size_t total = input.size() / bs;
+            size_t window = std::max<size_t>({schedule.serialThreshold, schedule.grainBlocks, 1}) * 4;
+            links.resize(std::min(window, total) * bs);
+            for (size_t start = 0; start < total; start += window) {
+                size_t blocks = std::min(window, total - start);
+                ConstBytesSpan source = input.subspan(start * bs, blocks * bs);
+                BytesSpan target = output.subspan(start * bs, blocks * bs);
+                BytesSpan scan = std::span{links}.first(blocks * bs);
+                utils::Scheduler::forEachChunk(blocks, schedule, [&](size_t, size_t first, size_t count) {
+                    BytesSpan link = scan.subspan(first * bs, count * bs);
+                    ConstBytesSpan ciphertext = source.subspan(first * bs, count * bs);
+                    cipher->decryptBlocks(ciphertext, link, count);
+                    utils::BlockOps::xorInto(link, ciphertext);
+                });
+                utils::BlockOps::xorInto(scan.first(bs), state);
+                utils::BlockOps::prefixXor(scan, bs);
+                utils::BlockOps::copy(state, scan.last(bs));
+                utils::Scheduler::forEachChunk(blocks, schedule, [&](size_t, size_t first, size_t count) {
+                    utils::BlockOps::xor3(target.subspan(first * bs, count * bs), scan.subspan(first * bs, count * bs),
+                                          source.subspan(first * bs, count * bs));
+                });
             }
-            size_t valid = padding->removePadding(result, bs);
-            result.resize(valid);
-            return result;
+        }
+    public:
+        PCBC(std::unique_ptr<IBlockCipher> c, std::unique_ptr<IPadding> p, ConstBytesSpan iv_)
+            : ICipherMode(std::move(c), std::move(p)), iv(iv_.begin(), iv_.end())
+        {
+            if (iv.size() != cipher->getBlockSize()) throw std::invalid_argument("Invalid IV size");
         }
     };
 }
\ No newline at end of file
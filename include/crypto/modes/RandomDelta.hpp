@@ -1,54 +1,105 @@
 #pragma once
 #include "crypto/interfaces/ICipherMode.hpp"
+#include "crypto/utils/BlockOps.hpp"
+#include "crypto/utils/Philox.hpp"
 #include <random>
 #include <cstring>
+#include <algorithm>
 namespace crypto::modes {
+    enum class DeltaGenerator {
+        MT19937,
+        Philox
+    };
     class RandomDelta : public ICipherMode {
         uint32_t seed;
-    public:
-        RandomDelta(std::unique_ptr<IBlockCipher> c, std::unique_ptr<IPadding> p, ConstBytesSpan iv)
-            : ICipherMode(std::move(c), std::move(p))
-        {
-            if (iv.size() < 4) throw std::invalid_argument("RandomDelta needs at least 4 bytes IV for seed");
-            std::memcpy(&seed, iv.data(), 4);
+        DeltaGenerator generator;
+        std::mt19937 gen;
+        std::uniform_int_distribution<uint16_t> dist{0, 255};
+        utils::Philox4x32 philox;
+        uint64_t position = 0;
+        void fillDeltas(BytesSpan deltas) {
+            for (auto& d : deltas) d = static_cast<Byte>(dist(gen));
+        }
+        void fillDeltas(uint64_t firstBlock, BytesSpan deltas) const {
+            size_t bs = cipher->getBlockSize();
+            for (size_t offset = 0; offset < deltas.size(); offset += bs) {
+                philox.fill(firstBlock + offset / bs, deltas.subspan(offset, bs));
+            }
+        }
+        static utils::Philox4x32::Key philoxKey(ConstBytesSpan iv) {
+            utils::Philox4x32::Key key{};
+            for (size_t i = 0; i < std::min<size_t>(iv.size(), 8); ++i) {
+                key[i / 4] |= static_cast<uint32_t>(iv[i]) << (8 * (i % 4));
+            }
+            return key;
         }
-        Bytes encrypt(ConstBytesSpan input) override {
-            Bytes data(input.begin(), input.end());
+    protected:
+        void resetChain() override {
+            gen.seed(seed);
+            dist.reset();
+            position = 0;
+        }
+        void encryptChunk(ConstBytesSpan input, BytesSpan output) override {
             size_t bs = cipher->getBlockSize();
-            padding->addPadding(data, bs);
-            Bytes result(data.size());
-            size_t blocks = data.size() / bs;
-            std::mt19937 gen(seed);
-            std::uniform_int_distribution<uint16_t> dist(0, 255);
-            for(size_t i=0; i<blocks; ++i) {
-                size_t offset = i * bs;
-                Bytes block(bs);
-                for(size_t j=0; j<bs; ++j) {
-                    Byte delta = static_cast<Byte>(dist(gen));
-                    block[j] = data[offset + j] ^ delta;
-                }
-                cipher->encryptBlock(block, std::span{result.data() + offset, bs});
+            size_t blocks = input.size() / bs;
+            if (generator == DeltaGenerator::Philox) {
+                utils::Scheduler::forEachChunk(blocks, schedule, [&](size_t, size_t first, size_t count) {
+                    Bytes scratch(count * bs);
+                    fillDeltas(position + first, scratch);
+                    utils::BlockOps::xorInto(scratch, input.subspan(first * bs, count * bs));
+                    cipher->encryptBlocks(scratch, output.subspan(first * bs, count * bs), count);
+                });
+                position += blocks;
+                return;
+            }
+            Bytes scratch(std::min(blocks, BATCH_BLOCKS) * bs);
+            for(size_t first=0; first<blocks; first+=BATCH_BLOCKS) {
+                size_t count = std::min(BATCH_BLOCKS, blocks - first);
+                BytesSpan batch = std::span{scratch.data(), count * bs};
+                fillDeltas(batch);
+                utils::BlockOps::xorInto(batch, input.subspan(first * bs, count * bs));
+                cipher->encryptBlocks(batch, output.subspan(first * bs, count * bs), count);
             }
-            return result;
         }
-        Bytes decrypt(ConstBytesSpan input) override {
+        void decryptChunk(ConstBytesSpan input, BytesSpan output) override {
              size_t bs = cipher->getBlockSize();
-             Bytes result(input.size());
              size_t blocks = input.size() / bs;
-             std::mt19937 gen(seed);
-             std::uniform_int_distribution<uint16_t> dist(0, 255);
-             for(size_t i=0; i<blocks; ++i) {
-                size_t offset = i * bs;
-                Bytes decryptedBlock(bs);
-                cipher->decryptBlock(input.subspan(offset, bs), decryptedBlock);
-                for(size_t j=0; j<bs; ++j) {
-                    Byte delta = static_cast<Byte>(dist(gen));
-                    result[offset + j] = decryptedBlock[j] ^ delta;
-                }
+             if (generator == DeltaGenerator::Philox) {
+                 utils::Scheduler::forEachChunk(blocks, schedule, [&](size_t, size_t first, size_t count) {
+                     BytesSpan out = output.subspan(first * bs, count * bs);
+                     cipher->decryptBlocks(input.subspan(first * bs, count * bs), out, count);
+                     Bytes deltas(count * bs);
+                     fillDeltas(position + first, deltas);
+                     utils::BlockOps::xorInto(out, deltas);
+                 });
+                 position += blocks;
+                 return;
+             }
+             Bytes deltas(std::min(blocks, BATCH_BLOCKS) * bs);
+             for(size_t first=0; first<blocks; first+=BATCH_BLOCKS) {
+                size_t count = std::min(BATCH_BLOCKS, blocks - first);
+                BytesSpan out = output.subspan(first * bs, count * bs);
+                cipher->decryptBlocks(input.subspan(first * bs, count * bs), out, count);
+                fillDeltas(std::span{deltas.data(), count * bs});
+                utils::BlockOps::xorInto(out, deltas);
              }
-             size_t valid = padding->removePadding(result, bs);
-             result.resize(valid);
-             return result;
+        }
+    public:
+        RandomDelta(std::unique_ptr<IBlockCipher> c, std::unique_ptr<IPadding> p, ConstBytesSpan iv,
+                    DeltaGenerator generator_ = DeltaGenerator::MT19937)
+            : ICipherMode(std::move(c), std::move(p)), generator(generator_), philox(philoxKey(iv))
+        {
+            if (iv.size() < 4) throw std::invalid_argument("RandomDelta needs at least 4 bytes IV for seed");
+            std::memcpy(&seed, iv.data(), 4);
+        }
+        [[nodiscard]] DeltaGenerator deltaGenerator() const {
+            return generator;
+        }
+        void seek(uint64_t offset, bool encrypt) {
+            if (generator != DeltaGenerator::Philox) throw std::invalid_argument("Seeking requires the Philox delta generator");
+            if (offset % cipher->getBlockSize() != 0) throw std::invalid_argument("Seek offset must be block aligned");
+            begin(encrypt);
+            position = offset / cipher->getBlockSize();
         }
     };
 }
\ No newline at end of file
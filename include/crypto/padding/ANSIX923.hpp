@@ -10,6 +10,10 @@ namespace crypto::padding {
             }
             data.push_back(static_cast<Byte>(paddingSize));
         }
+        void padBlock(BytesSpan block, size_t used) override {
+            std::fill(block.begin() + used, block.end() - 1, Byte{0});
+            block.back() = static_cast<Byte>(block.size() - used);
+        }
         size_t removePadding(ConstBytesSpan data, size_t blockSize) override {
             if (data.empty()) throw std::runtime_error("Empty data");
             size_t paddingSize = static_cast<size_t>(data.back());
@@ -14,6 +14,13 @@ namespace crypto::padding {
             }
             data.push_back(static_cast<Byte>(paddingSize));
         }
+        void padBlock(BytesSpan block, size_t used) override {
+            std::random_device rd;
+            std::mt19937 gen(rd());
+            std::uniform_int_distribution<> dis(0, 255);
+            for (size_t i = used; i + 1 < block.size(); ++i) block[i] = static_cast<Byte>(dis(gen));
+            block.back() = static_cast<Byte>(block.size() - used);
+        }
         size_t removePadding(ConstBytesSpan data, size_t blockSize) override {
             if (data.empty()) throw std::runtime_error("Empty data");
             size_t paddingSize = static_cast<size_t>(data.back());
@@ -9,6 +9,9 @@ namespace crypto::padding {
             Byte padByte = static_cast<Byte>(paddingSize);
             data.insert(data.end(), paddingSize, padByte);
         }
+        void padBlock(BytesSpan block, size_t used) override {
+            std::fill(block.begin() + used, block.end(), static_cast<Byte>(block.size() - used));
+        }
         size_t removePadding(ConstBytesSpan data, size_t blockSize) override {
             if (data.empty()) throw std::runtime_error("Empty data");
             Byte lastByte = data.back();
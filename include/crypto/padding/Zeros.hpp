@@ -9,6 +9,12 @@ namespace crypto::padding {
             if (paddingSize == 0) return;
             data.insert(data.end(), paddingSize, Byte{0});
         }
+        [[nodiscard]] size_t paddedSize(size_t dataSize, size_t blockSize) const override {
+            return (dataSize + blockSize - 1) / blockSize * blockSize;
+        }
+        void padBlock(BytesSpan block, size_t used) override {
+            std::fill(block.begin() + used, block.end(), Byte{0});
+        }
         size_t removePadding(ConstBytesSpan data, size_t blockSize) override {
             size_t newSize = data.size();
             while (newSize > 0 && data[newSize - 1] == Byte{0}) {
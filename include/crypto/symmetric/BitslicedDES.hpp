@@ -0,0 +1,27 @@
+#pragma once
+#include "crypto/symmetric/DES.hpp"
+#include <span>
+#include <vector>
+namespace crypto::symmetric {
+    class BitslicedDES {
+    public:
+        struct Stage {
+            const DES::KeySchedule* keys;
+            bool decrypt;
+        };
+        class LaneKeys {
+        public:
+            LaneKeys(std::span<const Stage> laneStages, size_t stagesPerLane);
+            [[nodiscard]] size_t lanes() const { return laneCount; }
+        private:
+            friend class BitslicedDES;
+            std::vector<uint64_t> masks;
+            size_t stages;
+            size_t laneCount;
+        };
+        [[nodiscard]] static size_t lanes();
+        static void crypt(const uint64_t* src, uint64_t* dst, size_t nBlocks, std::span<const Stage> stages);
+        static void crypt(const Byte* src, Byte* dst, size_t nBlocks, std::span<const Stage> stages);
+        static void crypt(const Byte* src, Byte* dst, size_t nBlocks, const LaneKeys& keys);
+    };
+}
\ No newline at end of file
@@ -1,16 +1,24 @@
 #pragma once
 #include "crypto/symmetric/DES.hpp"
 #include "crypto/utils/BitUtils.hpp"
-#include <vector>
-#include <memory>
+#include <array>
 namespace crypto::symmetric {
-    class DEAL : public IBlockCipher {
-        std::vector<std::unique_ptr<DES>> roundDes;
+    class DEAL final : public IBlockCipher {
+        static constexpr size_t ROUNDS = 6;
+        static constexpr size_t CHUNK_BLOCKS = 512;
+        std::array<DES::KeySchedule, ROUNDS> roundKeys;
     public:
         explicit DEAL(ConstBytesSpan key);
         size_t getBlockSize() const override { return 16; }
         size_t getKeySize() const override { return 16; }
         void encryptBlock(ConstBytesSpan src, BytesSpan dst) override;
         void decryptBlock(ConstBytesSpan src, BytesSpan dst) override;
+        void encryptBlocks(ConstBytesSpan src, BytesSpan dst, size_t nBlocks) override;
+        void decryptBlocks(ConstBytesSpan src, BytesSpan dst, size_t nBlocks) override;
+        [[nodiscard]] static constexpr size_t rounds() { return ROUNDS; }
+        [[nodiscard]] const DES::KeySchedule& roundKeySchedule(size_t round) const { return roundKeys[round]; }
+    private:
+        void cryptBlock(ConstBytesSpan src, BytesSpan dst, bool decrypt) const;
+        void cryptBlocks(ConstBytesSpan src, BytesSpan dst, size_t nBlocks, bool decrypt) const;
     };
 }
\ No newline at end of file
@@ -2,15 +2,26 @@
 #include "crypto/interfaces/IBlockCipher.hpp"
 #include <array>
 namespace crypto::symmetric {
-    class DES : public IBlockCipher {
+    class DES final : public IBlockCipher {
     public:
+        using KeySchedule = std::array<uint64_t, 16>;
         explicit DES(ConstBytesSpan key);
         size_t getBlockSize() const override { return 8; }
         size_t getKeySize() const override { return 8; }
         void encryptBlock(ConstBytesSpan src, BytesSpan dst) override;
         void decryptBlock(ConstBytesSpan src, BytesSpan dst) override;
+        void encryptBlocks(ConstBytesSpan src, BytesSpan dst, size_t nBlocks) override;
+        void decryptBlocks(ConstBytesSpan src, BytesSpan dst, size_t nBlocks) override;
+        [[nodiscard]] uint64_t encrypt64(uint64_t block) const;
+        [[nodiscard]] uint64_t decrypt64(uint64_t block) const;
+        [[nodiscard]] const KeySchedule& keySchedule() const { return subKeys; }
+        [[nodiscard]] static KeySchedule expandKey(uint64_t key64);
+        [[nodiscard]] static uint64_t crypt(uint64_t block, const KeySchedule& keys, bool decrypt);
+        [[nodiscard]] static uint64_t initialPermutation(uint64_t block);
+        [[nodiscard]] static uint64_t finalPermutation(uint64_t block);
+        template<size_t Lanes>
+        static void rounds(std::array<uint64_t, Lanes>& state, const KeySchedule& keys, bool decrypt);
     private:
-        std::array<uint64_t, 16> subKeys;
-        void generateSubKeys(uint64_t key64);
+        KeySchedule subKeys;
     };
 }
\ No newline at end of file
@@ -3,25 +3,36 @@
 #include <vector>
 #include <array>
 namespace crypto::symmetric {
-    class FROG : public IBlockCipher {
+    class FROG final : public IBlockCipher {
     public:
-        explicit FROG(ConstBytesSpan key);
+        static constexpr size_t NUM_ROUNDS = 8;
+        struct RoundKey {
+            std::array<uint8_t, 16>  xorBu;
+            std::array<uint8_t, 256> subst;
+            std::array<uint8_t, 16>  bombPerm;
+        };
+        struct ExpandedRound {
+            std::array<std::array<uint8_t, 256>, 16> table;
+        };
+        enum class KeyLayout { Compact, Expanded };
+        explicit FROG(ConstBytesSpan key, KeyLayout layout = KeyLayout::Compact);
         size_t getBlockSize() const override { return 16; }
         size_t getKeySize() const override { return 16; }
         void encryptBlock(ConstBytesSpan src, BytesSpan dst) override;
         void decryptBlock(ConstBytesSpan src, BytesSpan dst) override;
+        void encryptBlocks(ConstBytesSpan src, BytesSpan dst, size_t nBlocks) override;
+        void decryptBlocks(ConstBytesSpan src, BytesSpan dst, size_t nBlocks) override;
     private:
         static constexpr size_t BLOCK_SIZE = 16;
-        static constexpr size_t NUM_ROUNDS = 8;
         static constexpr size_t INTERNAL_KEY_SIZE = 2304;
-        struct RoundKey {
-            std::array<uint8_t, 16>  xorBu;
-            std::array<uint8_t, 256> subst;
-            std::array<uint8_t, 16>  bombPerm;
-        };
         std::vector<RoundKey> encryptKeys;
         std::vector<RoundKey> decryptKeys;
+        std::vector<ExpandedRound> expandedEncrypt;
+        std::vector<ExpandedRound> expandedDecrypt;
         void makeInternalKey(ConstBytesSpan userKey);
         void invertKeys();
+        void expandKeys();
+        void encryptRaw(uint8_t* blocks, size_t nBlocks) const;
+        void decryptRaw(uint8_t* blocks, size_t nBlocks) const;
     };
 }
\ No newline at end of file
@@ -0,0 +1,15 @@
+#pragma once
+#include "crypto/symmetric/FROG.hpp"
+namespace crypto::symmetric::frog_kernels {
+    using Kernel = void (*)(const FROG::RoundKey* keys, uint8_t* blocks, size_t nBlocks);
+    void encryptScalar(const FROG::RoundKey* keys, uint8_t* blocks, size_t nBlocks);
+    void decryptScalar(const FROG::RoundKey* keys, uint8_t* blocks, size_t nBlocks);
+    void encryptExpanded(const FROG::ExpandedRound* rounds, uint8_t* blocks, size_t nBlocks);
+    void decryptExpanded(const FROG::ExpandedRound* rounds, uint8_t* blocks, size_t nBlocks);
+    void encryptSSSE3(const FROG::RoundKey* keys, uint8_t* blocks, size_t nBlocks);
+    void decryptSSSE3(const FROG::RoundKey* keys, uint8_t* blocks, size_t nBlocks);
+    void encryptAVX2(const FROG::RoundKey* keys, uint8_t* blocks, size_t nBlocks);
+    void decryptAVX2(const FROG::RoundKey* keys, uint8_t* blocks, size_t nBlocks);
+    void encryptAVX512VBMI(const FROG::RoundKey* keys, uint8_t* blocks, size_t nBlocks);
+    void decryptAVX512VBMI(const FROG::RoundKey* keys, uint8_t* blocks, size_t nBlocks);
+}
\ No newline at end of file
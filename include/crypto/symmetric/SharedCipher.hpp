@@ -0,0 +1,19 @@
+#pragma once
+#include "crypto/interfaces/IBlockCipher.hpp"
+#include <memory>
+#include <stdexcept>
+namespace crypto::symmetric {
+    class SharedCipher final : public IBlockCipher {
+        std::shared_ptr<IBlockCipher> inner;
+    public:
+        explicit SharedCipher(std::shared_ptr<IBlockCipher> cipher) : inner(std::move(cipher)) {
+            if (!inner) throw std::invalid_argument("SharedCipher requires a cipher");
+        }
+        size_t getBlockSize() const override { return inner->getBlockSize(); }
+        size_t getKeySize() const override { return inner->getKeySize(); }
+        void encryptBlock(ConstBytesSpan src, BytesSpan dst) override { inner->encryptBlock(src, dst); }
+        void decryptBlock(ConstBytesSpan src, BytesSpan dst) override { inner->decryptBlock(src, dst); }
+        void encryptBlocks(ConstBytesSpan src, BytesSpan dst, size_t nBlocks) override { inner->encryptBlocks(src, dst, nBlocks); }
+        void decryptBlocks(ConstBytesSpan src, BytesSpan dst, size_t nBlocks) override { inner->decryptBlocks(src, dst, nBlocks); }
+    };
+}
\ No newline at end of file
@@ -1,8 +1,9 @@
 #pragma once
 #include "crypto/symmetric/DES.hpp"
-#include <memory>
+#include "crypto/symmetric/BitslicedDES.hpp"
+#include <stdexcept>
 namespace crypto::symmetric {
-    class TripleDES : public IBlockCipher {
+    class TripleDES final : public IBlockCipher {
         DES des1, des2, des3;
     public:
         explicit TripleDES(ConstBytesSpan key)
@@ -14,17 +15,12 @@ namespace crypto::symmetric {
         }
         size_t getBlockSize() const override { return 8; }
         size_t getKeySize() const override { return 24; }
-        void encryptBlock(ConstBytesSpan src, BytesSpan dst) override {
-            std::array<Byte, 8> temp1, temp2;
-            des1.encryptBlock(src, temp1);
-            des2.decryptBlock(temp1, temp2);
-            des3.encryptBlock(temp2, dst);
-        }
-        void decryptBlock(ConstBytesSpan src, BytesSpan dst) override {
-            std::array<Byte, 8> temp1, temp2;
-            des3.decryptBlock(src, temp1);
-            des2.encryptBlock(temp1, temp2);
-            des1.decryptBlock(temp2, dst);
-        }
+        void encryptBlock(ConstBytesSpan src, BytesSpan dst) override;
+        void decryptBlock(ConstBytesSpan src, BytesSpan dst) override;
+        void encryptBlocks(ConstBytesSpan src, BytesSpan dst, size_t nBlocks) override;
+        void decryptBlocks(ConstBytesSpan src, BytesSpan dst, size_t nBlocks) override;
+        [[nodiscard]] std::array<BitslicedDES::Stage, 3> stages(bool decrypt) const;
+    private:
+        void cryptBlocks(ConstBytesSpan src, BytesSpan dst, size_t nBlocks, bool decrypt) const;
     };
 }
\ No newline at end of file
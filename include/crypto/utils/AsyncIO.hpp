@@ -0,0 +1,22 @@
+#pragma once
+#include "crypto/common/types.hpp"
+#include <cstdint>
+#include <memory>
+#include <span>
+namespace crypto::utils {
+    class AsyncIO {
+    public:
+        struct Completion {
+            size_t slot;
+            int64_t result;
+        };
+        static constexpr size_t DIRECT_ALIGNMENT = 4096;
+        virtual ~AsyncIO() = default;
+        static std::unique_ptr<AsyncIO> create(std::span<const BytesSpan> buffers, size_t queueDepth);
+        static std::unique_ptr<AsyncIO> createThreadPool(std::span<const BytesSpan> buffers, size_t queueDepth);
+        virtual void submitRead(int fd, size_t slot, size_t length, uint64_t offset) = 0;
+        virtual void submitWrite(int fd, size_t slot, size_t length, uint64_t offset) = 0;
+        virtual Completion wait() = 0;
+        [[nodiscard]] virtual const char* name() const = 0;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <span>
+#include <string>
+#include <vector>
+#include "crypto/interfaces/ICipherMode.hpp"
+#include "crypto/utils/FileProcessor.hpp"
+namespace crypto::utils {
+    class BatchProcessor {
+    public:
+        using ModeFactory = std::function<std::unique_ptr<ICipherMode>()>;
+        struct Job {
+            std::filesystem::path input;
+            std::filesystem::path output;
+            std::string error;
+        };
+        struct Result {
+            std::filesystem::path input;
+            std::filesystem::path output;
+            bool ok = false;
+            uint64_t bytesIn = 0;
+            uint64_t bytesOut = 0;
+            double seconds = 0.0;
+            std::string error;
+        };
+        struct Options {
+            size_t memoryBudget = 256 << 20;
+            uint64_t largeFileThreshold = 16 << 20;
+            size_t chunkSize = FileProcessor::CHUNK_SIZE;
+        };
+        static std::vector<Job> scanDirectory(const std::filesystem::path& inputRoot, const std::filesystem::path& outputRoot);
+        static std::vector<Job> readManifest(const std::filesystem::path& manifest, const std::filesystem::path& outputRoot);
+        static std::vector<Result> run(std::span<const Job> jobs, const ModeFactory& factory, bool encrypt, const Options& options);
+        static std::vector<Result> run(std::span<const Job> jobs, const ModeFactory& factory, bool encrypt);
+        static void writeReport(std::span<const Result> results, std::ostream& out);
+    };
+}
\ No newline at end of file
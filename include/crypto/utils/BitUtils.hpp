@@ -5,16 +5,37 @@
 namespace crypto::utils {
     class BitUtils {
     public:
-        template<size_t N>
-        static uint64_t permute(uint64_t input, const std::array<uint8_t, N>& table) {
+        template<size_t N, size_t InBits = 64>
+        static constexpr uint64_t permute(uint64_t input, const std::array<uint8_t, N>& table) {
             uint64_t output = 0;
             for (size_t i = 0; i < N; ++i) {
-                if ((input >> (64 - table[i])) & 1) {
+                if ((input >> (InBits - table[i])) & 1) {
                     output |= (1ULL << (N - 1 - i));
                 }
             }
             return output;
         }
+        template<size_t InBytes>
+        using PermutationTable = std::array<std::array<uint64_t, 256>, InBytes>;
+        template<size_t N, size_t InBits = 64>
+        static constexpr PermutationTable<InBits / 8> makePermutationTable(const std::array<uint8_t, N>& table) {
+            static_assert(InBits % 8 == 0 && InBits <= 64, "Permutation input must be whole bytes");
+            PermutationTable<InBits / 8> lut{};
+            for (size_t byte = 0; byte < InBits / 8; ++byte) {
+                for (uint64_t value = 0; value < 256; ++value) {
+                    lut[byte][value] = permute<N, InBits>(value << (InBits - 8 - 8 * byte), table);
+                }
+            }
+            return lut;
+        }
+        template<size_t InBytes>
+        static constexpr uint64_t permute(uint64_t input, const PermutationTable<InBytes>& lut) {
+            uint64_t output = 0;
+            for (size_t byte = 0; byte < InBytes; ++byte) {
+                output |= lut[byte][(input >> (8 * (InBytes - 1 - byte))) & 0xFF];
+            }
+            return output;
+        }
         static uint32_t rol28(uint32_t value, int shifts) {
             return ((value << shifts) | (value >> (28 - shifts))) & 0x0FFFFFFF;
         }
@@ -27,7 +48,7 @@ namespace crypto::utils {
         }
         static void uint64ToBytes(uint64_t val, BytesSpan out) {
             for (int i = 7; i >= 0; --i) {
-                out[7 - i] = static_cast<Byte>(val & 0xFF);
+                out[i] = static_cast<Byte>(val & 0xFF);
                 val >>= 8;
             }
         }
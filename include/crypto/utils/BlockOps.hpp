@@ -0,0 +1,11 @@
+#pragma once
+#include "crypto/common/types.hpp"
+namespace crypto::utils {
+    class BlockOps {
+    public:
+        static void xorInto(BytesSpan dst, ConstBytesSpan src);
+        static void xor3(BytesSpan dst, ConstBytesSpan a, ConstBytesSpan b);
+        static void prefixXor(BytesSpan data, size_t stride);
+        static void copy(BytesSpan dst, ConstBytesSpan src);
+    };
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+#pragma once
+#include <optional>
+#include <string_view>
+namespace crypto::utils {
+    enum class SimdLevel { Scalar, SSSE3, AVX2, AVX512, AVX512VBMI };
+    class CpuFeatures {
+    public:
+        static constexpr const char* ENV_VARIABLE = "CRYPTO_SIMD";
+        [[nodiscard]] static SimdLevel detected();
+        [[nodiscard]] static SimdLevel active();
+        static void force(SimdLevel level);
+        static void reset();
+        [[nodiscard]] static std::string_view toString(SimdLevel level);
+        [[nodiscard]] static std::optional<SimdLevel> parse(std::string_view name);
+    };
+}
\ No newline at end of file
@@ -1,15 +1,48 @@
 #pragma once
 #include <string>
 #include <filesystem>
+#include <fstream>
 #include "crypto/interfaces/ICipherMode.hpp"
 namespace crypto::utils {
     class FileProcessor {
     public:
+        enum class Backend {
+            Stream,
+            MemoryMapped,
+            Pipelined,
+            Async
+        };
+        static constexpr size_t CHUNK_SIZE = 4 << 20;
+        static constexpr size_t IN_FLIGHT = 4;
+        struct Options {
+            Backend backend = Backend::Stream;
+            size_t chunkSize = CHUNK_SIZE;
+            size_t inFlight = IN_FLIGHT;
+            bool direct = false;
+        };
         static void process(
             const std::filesystem::path& inputFile,
             const std::filesystem::path& outputFile,
             ICipherMode& mode,
-            bool encrypt
+            bool encrypt,
+            const Options& options
         );
+        static void process(
+            const std::filesystem::path& inputFile,
+            const std::filesystem::path& outputFile,
+            ICipherMode& mode,
+            bool encrypt,
+            Backend backend = Backend::Stream
+        );
+    private:
+        static std::ifstream openInput(const std::filesystem::path& inPath, ICipherMode& mode, uint64_t payload, size_t tag);
+        static void processStream(const std::filesystem::path& inPath, const std::filesystem::path& outPath,
+                                  ICipherMode& mode, uint64_t payload, size_t tag, const Options& options);
+        static void processMapped(const std::filesystem::path& inPath, const std::filesystem::path& outPath,
+                                  ICipherMode& mode, bool encrypt, uint64_t payload, size_t tag, const Options& options);
+        static void processPipelined(const std::filesystem::path& inPath, const std::filesystem::path& outPath,
+                                     ICipherMode& mode, uint64_t payload, size_t tag, const Options& options);
+        static void processAsync(const std::filesystem::path& inPath, const std::filesystem::path& outPath,
+                                 ICipherMode& mode, uint64_t payload, size_t tag, const Options& options);
     };
 }
\ No newline at end of file
@@ -0,0 +1,32 @@
+#pragma once
+#include "crypto/common/types.hpp"
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+namespace crypto::utils {
+    class KeystreamRing {
+    public:
+        using Producer = std::function<void(BytesSpan)>;
+        KeystreamRing(size_t segmentSize, size_t segmentCount, Producer producer);
+        ~KeystreamRing();
+        KeystreamRing(const KeystreamRing&) = delete;
+        KeystreamRing& operator=(const KeystreamRing&) = delete;
+        void apply(ConstBytesSpan input, BytesSpan output);
+    private:
+        void produce();
+        std::vector<Bytes> segments;
+        std::vector<bool> ready;
+        Producer producer;
+        size_t writeIndex = 0;
+        size_t readIndex = 0;
+        size_t readOffset = 0;
+        bool stopping = false;
+        std::exception_ptr failure;
+        std::mutex mutex;
+        std::condition_variable changed;
+        std::thread worker;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+#include "crypto/common/types.hpp"
+#include <cstdint>
+#include <filesystem>
+namespace crypto::utils {
+    class MappedFile {
+        int fd = -1;
+        Byte* base = nullptr;
+        uint64_t length = 0;
+        uint64_t released = 0;
+        MappedFile(int fd_, uint64_t length_, bool writable);
+        void unmap();
+    public:
+        static MappedFile openRead(const std::filesystem::path& path);
+        static MappedFile create(const std::filesystem::path& path, uint64_t size);
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        ~MappedFile();
+        [[nodiscard]] BytesSpan bytes() const {
+            return {base, static_cast<size_t>(length)};
+        }
+        [[nodiscard]] uint64_t size() const {
+            return length;
+        }
+        void release(uint64_t end);
+        void close(uint64_t finalSize);
+    };
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+#include "crypto/common/types.hpp"
+#include <array>
+#include <cstdint>
+namespace crypto::utils {
+    class Philox4x32 {
+    public:
+        using Counter = std::array<uint32_t, 4>;
+        using Key = std::array<uint32_t, 2>;
+        static constexpr size_t ROUNDS = 10;
+        static constexpr size_t OUTPUT_BYTES = 16;
+        static constexpr Counter generate(Counter counter, Key key) {
+            for (size_t round = 0; round < ROUNDS; ++round) {
+                uint64_t p0 = static_cast<uint64_t>(MULTIPLIER_0) * counter[0];
+                uint64_t p1 = static_cast<uint64_t>(MULTIPLIER_1) * counter[2];
+                counter = {
+                    static_cast<uint32_t>(p1 >> 32) ^ counter[1] ^ key[0],
+                    static_cast<uint32_t>(p1),
+                    static_cast<uint32_t>(p0 >> 32) ^ counter[3] ^ key[1],
+                    static_cast<uint32_t>(p0)
+                };
+                key[0] += WEYL_0;
+                key[1] += WEYL_1;
+            }
+            return counter;
+        }
+        explicit Philox4x32(Key key_) : key(key_) {}
+        void fill(uint64_t index, BytesSpan out) const {
+            for (size_t offset = 0, word = 0; offset < out.size(); offset += OUTPUT_BYTES, ++word) {
+                Counter value = generate({static_cast<uint32_t>(index), static_cast<uint32_t>(index >> 32), static_cast<uint32_t>(word), 0}, key);
+                for (size_t i = 0; i < OUTPUT_BYTES && offset + i < out.size(); ++i) {
+                    out[offset + i] = static_cast<Byte>(value[i / 4] >> (8 * (i % 4)));
+                }
+            }
+        }
+    private:
+        static constexpr uint32_t MULTIPLIER_0 = 0xD2511F53;
+        static constexpr uint32_t MULTIPLIER_1 = 0xCD9E8D57;
+        static constexpr uint32_t WEYL_0 = 0x9E3779B9;
+        static constexpr uint32_t WEYL_1 = 0xBB67AE85;
+        Key key;
+    };
+}
\ No newline at end of file
@@ -4,20 +4,24 @@
 #include "crypto/asymmetric/RSA.hpp"
 #include "crypto/interfaces/IAsymmetricCipher.hpp"
 #include "crypto/padding/RSA_PKCS1.hpp"
+#include "crypto/utils/Scheduler.hpp"
 namespace crypto::utils {
     class RSAFileProcessor {
     public:
+        static constexpr ScheduleOptions DEFAULT_SCHEDULE{1, 1};
         static void encryptFile(
             const std::filesystem::path& inPath,
             const std::filesystem::path& outPath,
             const PublicKey& pubKey,
-            size_t keySizeBits
+            size_t keySizeBits,
+            const ScheduleOptions& schedule = DEFAULT_SCHEDULE
         );
         static void decryptFile(
             const std::filesystem::path& inPath,
             const std::filesystem::path& outPath,
             const PrivateKey& privKey,
-            size_t keySizeBits
+            size_t keySizeBits,
+            const ScheduleOptions& schedule = DEFAULT_SCHEDULE
         );
     };
 }
\ No newline at end of file
@@ -0,0 +1,32 @@
+#pragma once
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <algorithm>
+#include <cstddef>
+namespace crypto::utils {
+    struct ScheduleOptions {
+        size_t grainBlocks = 1024;
+        size_t serialThreshold = 4096;
+    };
+    class Scheduler {
+    public:
+        template<typename Body>
+        static void forEachChunk(size_t total, const ScheduleOptions& options, Body&& body) {
+            size_t grain = std::max<size_t>(options.grainBlocks, 1);
+            size_t chunkCount = (total + grain - 1) / grain;
+            auto runChunks = [&](size_t begin, size_t end) {
+                for (size_t chunk = begin; chunk < end; ++chunk) {
+                    size_t first = chunk * grain;
+                    body(chunk, first, std::min(grain, total - first));
+                }
+            };
+            if (total <= options.serialThreshold || chunkCount == 1) {
+                runChunks(0, chunkCount);
+                return;
+            }
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, chunkCount), [&](const tbb::blocked_range<size_t>& range) {
+                runChunks(range.begin(), range.end());
+            });
+        }
+    };
+}
\ No newline at end of file
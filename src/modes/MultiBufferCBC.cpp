@@ -0,0 +1,172 @@
+#include "crypto/modes/MultiBufferCBC.hpp"
+#include "crypto/symmetric/BitslicedDES.hpp"
+#include "crypto/symmetric/DEAL.hpp"
+#include "crypto/symmetric/DES.hpp"
+#include "crypto/symmetric/TripleDES.hpp"
+#include "crypto/utils/BitUtils.hpp"
+#include "crypto/utils/BlockOps.hpp"
+#include "crypto/utils/Scheduler.hpp"
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+namespace crypto::modes {
+    using symmetric::BitslicedDES;
+    using utils::BitUtils;
+    namespace {
+        struct Lane {
+            const MultiBufferCBC::Stream* stream;
+            size_t fullBlocks;
+            size_t totalBlocks;
+            Bytes finalBlock;
+        };
+        struct Task {
+            std::vector<Lane*> lanes;
+            IBlockCipher* cipher;
+            std::vector<BitslicedDES::Stage> stages;
+            size_t stagesPerLane;
+            bool feistel;
+        };
+        struct DESPass {
+            std::vector<BitslicedDES::Stage> stages;
+            size_t stagesPerLane;
+            BitslicedDES::LaneKeys keys;
+            DESPass(std::vector<BitslicedDES::Stage> stages_, size_t stagesPerLane_)
+                : stages(std::move(stages_)), stagesPerLane(stagesPerLane_), keys(stages, stagesPerLane) {}
+        };
+        void cryptDESLanes(const DESPass& pass, BytesSpan work, size_t active) {
+            size_t bulk = std::min(active, pass.keys.lanes()) / 64 * 64;
+            if (bulk > 0) BitslicedDES::crypt(work.data(), work.data(), bulk, pass.keys);
+            for (size_t i = bulk; i < active; ++i) {
+                BytesSpan block = work.subspan(i * 8, 8);
+                uint64_t value = BitUtils::bytesToUInt64(block);
+                for (size_t s = 0; s < pass.stagesPerLane; ++s) {
+                    const auto& stage = pass.stages[i * pass.stagesPerLane + s];
+                    value = symmetric::DES::crypt(value, *stage.keys, stage.decrypt);
+                }
+                BitUtils::uint64ToBytes(value, block);
+            }
+        }
+        void cryptFeistelLanes(std::span<const DESPass> rounds, BytesSpan work, BytesSpan halves, size_t active) {
+            BytesSpan left = halves.first(active * 8);
+            BytesSpan right = halves.subspan(active * 8, active * 8);
+            BytesSpan round = halves.subspan(active * 16, active * 8);
+            for (size_t i = 0; i < active; ++i) {
+                utils::BlockOps::copy(left.subspan(i * 8, 8), work.subspan(i * 16, 8));
+                utils::BlockOps::copy(right.subspan(i * 8, 8), work.subspan(i * 16 + 8, 8));
+            }
+            for (const auto& pass : rounds) {
+                utils::BlockOps::copy(round, right);
+                cryptDESLanes(pass, round, active);
+                utils::BlockOps::xorInto(left, round);
+                std::swap(left, right);
+            }
+            for (size_t i = 0; i < active; ++i) {
+                utils::BlockOps::copy(work.subspan(i * 16, 8), right.subspan(i * 8, 8));
+                utils::BlockOps::copy(work.subspan(i * 16 + 8, 8), left.subspan(i * 8, 8));
+            }
+        }
+        std::vector<DESPass> planPasses(const Task& task) {
+            std::vector<DESPass> passes;
+            if (task.stagesPerLane == 0) return passes;
+            if (!task.feistel) {
+                passes.emplace_back(task.stages, task.stagesPerLane);
+                return passes;
+            }
+            passes.reserve(task.stagesPerLane);
+            for (size_t r = 0; r < task.stagesPerLane; ++r) {
+                std::vector<BitslicedDES::Stage> round;
+                round.reserve(task.lanes.size());
+                for (size_t i = 0; i < task.lanes.size(); ++i) round.push_back(task.stages[i * task.stagesPerLane + r]);
+                passes.emplace_back(std::move(round), 1);
+            }
+            return passes;
+        }
+        void runTask(const Task& task) {
+            size_t bs = task.lanes.front()->stream->cipher->getBlockSize();
+            std::vector<DESPass> passes = planPasses(task);
+            Bytes work(task.lanes.size() * bs);
+            Bytes halves(task.feistel ? task.lanes.size() * 24 : 0);
+            size_t active = task.lanes.size();
+            for (size_t t = 0; t < task.lanes.front()->totalBlocks; ++t) {
+                while (task.lanes[active - 1]->totalBlocks <= t) --active;
+                for (size_t i = 0; i < active; ++i) {
+                    const Lane& lane = *task.lanes[i];
+                    BytesSpan x = std::span{work.data() + i * bs, bs};
+                    ConstBytesSpan plain = t < lane.fullBlocks ? lane.stream->input.subspan(t * bs, bs) : std::span{lane.finalBlock};
+                    ConstBytesSpan chain = t == 0 ? lane.stream->iv : lane.stream->output.subspan((t - 1) * bs, bs);
+                    utils::BlockOps::xor3(x, plain, chain);
+                }
+                BytesSpan batch = std::span{work}.first(active * bs);
+                if (task.feistel) cryptFeistelLanes(passes, batch, halves, active);
+                else if (!passes.empty()) cryptDESLanes(passes.front(), batch, active);
+                else task.cipher->encryptBlocks(batch, batch, active);
+                for (size_t i = 0; i < active; ++i) {
+                    const Lane& lane = *task.lanes[i];
+                    utils::BlockOps::copy(lane.stream->output.subspan(t * bs, bs), std::span{work}.subspan(i * bs, bs));
+                }
+            }
+        }
+    }
+    size_t MultiBufferCBC::encryptedSize(size_t plainSize, size_t blockSize) const {
+        return padding ? padding->paddedSize(plainSize, blockSize) : plainSize;
+    }
+    std::vector<size_t> MultiBufferCBC::encrypt(std::span<const Stream> streams) {
+        std::vector<Lane> lanes;
+        lanes.reserve(streams.size());
+        std::vector<size_t> sizes;
+        sizes.reserve(streams.size());
+        for (const auto& stream : streams) {
+            size_t bs = stream.cipher->getBlockSize();
+            size_t total = encryptedSize(stream.input.size(), bs);
+            if (stream.iv.size() != bs) throw std::invalid_argument("Invalid IV size");
+            if (total % bs != 0) throw std::invalid_argument("Input is not a multiple of the block size");
+            if (stream.output.size() < total) throw std::invalid_argument("Output buffer too small");
+            Lane lane{&stream, stream.input.size() / bs, total / bs, {}};
+            if (lane.totalBlocks > lane.fullBlocks) {
+                size_t used = stream.input.size() - lane.fullBlocks * bs;
+                lane.finalBlock.assign(stream.input.end() - used, stream.input.end());
+                lane.finalBlock.resize(bs);
+                padding->padBlock(lane.finalBlock, used);
+            }
+            sizes.push_back(total);
+            if (lane.totalBlocks > 0) lanes.push_back(std::move(lane));
+        }
+        std::vector<Lane*> desLanes, tripleDesLanes, dealLanes;
+        std::map<IBlockCipher*, std::vector<Lane*>> cipherLanes;
+        for (auto& lane : lanes) {
+            IBlockCipher* cipher = lane.stream->cipher;
+            if (dynamic_cast<symmetric::DES*>(cipher)) desLanes.push_back(&lane);
+            else if (dynamic_cast<symmetric::TripleDES*>(cipher)) tripleDesLanes.push_back(&lane);
+            else if (dynamic_cast<symmetric::DEAL*>(cipher)) dealLanes.push_back(&lane);
+            else cipherLanes[cipher].push_back(&lane);
+        }
+        std::vector<Task> tasks;
+        auto addTasks = [&](std::vector<Lane*>& group, IBlockCipher* cipher, size_t stagesPerLane, bool feistel) {
+            std::stable_sort(group.begin(), group.end(), [](const Lane* a, const Lane* b) {
+                return a->totalBlocks > b->totalBlocks;
+            });
+            for (size_t first = 0; first < group.size(); first += MAX_LANES) {
+                Task task{{group.begin() + first, group.begin() + std::min(group.size(), first + MAX_LANES)}, cipher, {}, stagesPerLane, feistel};
+                for (const Lane* lane : task.lanes) {
+                    if (auto* des = dynamic_cast<symmetric::DES*>(lane->stream->cipher)) {
+                        task.stages.push_back({&des->keySchedule(), false});
+                    } else if (auto* tripleDes = dynamic_cast<symmetric::TripleDES*>(lane->stream->cipher)) {
+                        auto plan = tripleDes->stages(false);
+                        task.stages.insert(task.stages.end(), plan.begin(), plan.end());
+                    } else if (auto* deal = dynamic_cast<symmetric::DEAL*>(lane->stream->cipher)) {
+                        for (size_t r = 0; r < symmetric::DEAL::rounds(); ++r) task.stages.push_back({&deal->roundKeySchedule(r), false});
+                    }
+                }
+                tasks.push_back(std::move(task));
+            }
+        };
+        addTasks(desLanes, nullptr, 1, false);
+        addTasks(tripleDesLanes, nullptr, 3, false);
+        addTasks(dealLanes, nullptr, symmetric::DEAL::rounds(), true);
+        for (auto& [cipher, group] : cipherLanes) addTasks(group, cipher, 0, false);
+        utils::Scheduler::forEachChunk(tasks.size(), utils::ScheduleOptions{1, 1}, [&](size_t, size_t first, size_t count) {
+            for (size_t i = first; i < first + count; ++i) runTask(tasks[i]);
+        });
+        return sizes;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,258 @@
+#include "crypto/symmetric/BitslicedDES.hpp"
+#include "crypto/symmetric/DESTables.hpp"
+#include "crypto/utils/BitUtils.hpp"
+#include "crypto/utils/CpuFeatures.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+namespace crypto::symmetric {
+    using utils::BitUtils;
+    using utils::CpuFeatures;
+    using utils::SimdLevel;
+    using namespace des_tables;
+    using Slice128 = uint64_t __attribute__((vector_size(16)));
+    using Slice256 = uint64_t __attribute__((vector_size(32)));
+    using Slice512 = uint64_t __attribute__((vector_size(64)));
+    static constexpr size_t MAX_LANES = 512;
+    static constexpr std::array<std::array<std::array<uint16_t, 4>, 4>, 8> makeMintermMasks() {
+        std::array<std::array<std::array<uint16_t, 4>, 4>, 8> masks{};
+        for (size_t box = 0; box < 8; ++box) {
+            for (size_t row = 0; row < 4; ++row) {
+                for (size_t col = 0; col < 16; ++col) {
+                    uint8_t s = S_BOX[box][row * 16 + col];
+                    for (size_t out = 0; out < 4; ++out) {
+                        if ((s >> (3 - out)) & 1) masks[box][row][out] |= static_cast<uint16_t>(1u << col);
+                    }
+                }
+            }
+        }
+        return masks;
+    }
+    static constexpr auto MINTERM_MASKS = makeMintermMasks();
+    static constexpr std::array<uint8_t, 32> makeInversePermutation() {
+        std::array<uint8_t, 32> inv{};
+        for (size_t i = 0; i < 32; ++i) inv[P_TABLE[i] - 1] = static_cast<uint8_t>(i);
+        return inv;
+    }
+    static constexpr auto P_INVERSE = makeInversePermutation();
+    template<typename Slice, uint16_t Mask, size_t... Col>
+    [[gnu::always_inline]] static inline void anyMinterm(Slice& acc, const Slice* m, std::index_sequence<Col...>) {
+        ((acc = ((Mask >> Col) & 1) ? (acc | m[Col]) : acc), ...);
+    }
+    template<typename Slice, size_t Box, size_t Out, size_t Row>
+    [[gnu::always_inline]] static inline void rowOutput(Slice& target, const Slice* m, const Slice* r) {
+        Slice any{};
+        anyMinterm<Slice, MINTERM_MASKS[Box][Row][Out]>(any, m, std::make_index_sequence<16>{});
+        target ^= r[Row] & any;
+    }
+    template<typename Slice, size_t Box, size_t Out, size_t... Row>
+    [[gnu::always_inline]] static inline void sboxOutput(Slice& target, const Slice* m, const Slice* r, std::index_sequence<Row...>) {
+        (rowOutput<Slice, Box, Out, Row>(target, m, r), ...);
+    }
+    template<typename Slice, size_t Box>
+    [[gnu::always_inline]] static inline void sboxRound(Slice* left, const Slice* right, const Slice* keyMasks) {
+        Slice x[6];
+        for (size_t j = 0; j < 6; ++j) x[j] = right[E_TABLE[Box * 6 + j] - 1] ^ keyMasks[Box * 6 + j];
+        Slice ab[4] = {~x[1] & ~x[2], ~x[1] & x[2], x[1] & ~x[2], x[1] & x[2]};
+        Slice cd[4] = {~x[3] & ~x[4], ~x[3] & x[4], x[3] & ~x[4], x[3] & x[4]};
+        Slice rows[4] = {~x[0] & ~x[5], ~x[0] & x[5], x[0] & ~x[5], x[0] & x[5]};
+        Slice m[16];
+        for (size_t col = 0; col < 16; ++col) m[col] = ab[col >> 2] & cd[col & 3];
+        constexpr auto rowSeq = std::make_index_sequence<4>{};
+        sboxOutput<Slice, Box, 0>(left[P_INVERSE[Box * 4 + 0]], m, rows, rowSeq);
+        sboxOutput<Slice, Box, 1>(left[P_INVERSE[Box * 4 + 1]], m, rows, rowSeq);
+        sboxOutput<Slice, Box, 2>(left[P_INVERSE[Box * 4 + 2]], m, rows, rowSeq);
+        sboxOutput<Slice, Box, 3>(left[P_INVERSE[Box * 4 + 3]], m, rows, rowSeq);
+    }
+    template<typename Slice, size_t... Box>
+    [[gnu::always_inline]] static inline void feistelRound(Slice* left, const Slice* right, const Slice* keyMasks, std::index_sequence<Box...>) {
+        (sboxRound<Slice, Box>(left, right, keyMasks), ...);
+    }
+    static void transpose64(uint64_t* a) {
+        uint64_t m = 0x00000000FFFFFFFFULL;
+        for (size_t j = 32; j != 0; j >>= 1, m ^= (m << j)) {
+            for (size_t k = 0; k < 64; k = ((k | j) + 1) & ~j) {
+                uint64_t t = (a[k] ^ (a[k | j] >> j)) & m;
+                a[k] ^= t;
+                a[k | j] ^= (t << j);
+            }
+        }
+    }
+    template<typename Slice>
+    [[gnu::always_inline]] static inline void load(const uint64_t* src, Slice* slices) {
+        constexpr size_t GROUPS = sizeof(Slice) / sizeof(uint64_t);
+        alignas(Slice) uint64_t lanes[64][GROUPS];
+        for (size_t g = 0; g < GROUPS; ++g) {
+            uint64_t a[64];
+            std::memcpy(a, src + g * 64, sizeof(a));
+            transpose64(a);
+            for (size_t k = 0; k < 64; ++k) lanes[k][g] = a[k];
+        }
+        for (size_t k = 0; k < 64; ++k) std::memcpy(&slices[k], lanes[k], sizeof(Slice));
+    }
+    template<typename Slice>
+    [[gnu::always_inline]] static inline void store(const Slice* slices, uint64_t* dst) {
+        constexpr size_t GROUPS = sizeof(Slice) / sizeof(uint64_t);
+        alignas(Slice) uint64_t lanes[64][GROUPS];
+        for (size_t k = 0; k < 64; ++k) std::memcpy(lanes[k], &slices[k], sizeof(Slice));
+        for (size_t g = 0; g < GROUPS; ++g) {
+            uint64_t a[64];
+            for (size_t k = 0; k < 64; ++k) a[k] = lanes[k][g];
+            transpose64(a);
+            std::memcpy(dst + g * 64, a, sizeof(a));
+        }
+    }
+    struct UniformKeys {
+        std::span<const BitslicedDES::Stage> stages;
+        [[nodiscard]] size_t stageCount() const { return stages.size(); }
+        [[nodiscard]] UniformKeys advance(size_t) const { return *this; }
+        template<typename Slice>
+        [[gnu::always_inline]] inline void load(size_t stage, size_t round, Slice* masks) const {
+            uint64_t k = (*stages[stage].keys)[stages[stage].decrypt ? 15 - round : round];
+            for (size_t bit = 0; bit < 48; ++bit) masks[bit] = Slice{} - ((k >> (47 - bit)) & 1);
+        }
+    };
+    struct SlicedKeys {
+        const uint64_t* masks;
+        size_t stages;
+        [[nodiscard]] size_t stageCount() const { return stages; }
+        [[nodiscard]] SlicedKeys advance(size_t groups) const { return {masks + groups * stages * 16 * 48, stages}; }
+        template<typename Slice>
+        [[gnu::always_inline]] inline void load(size_t stage, size_t round, Slice* out) const {
+            constexpr size_t GROUPS = sizeof(Slice) / sizeof(uint64_t);
+            const uint64_t* base = masks + (stage * 16 + round) * 48;
+            for (size_t bit = 0; bit < 48; ++bit) {
+                alignas(Slice) uint64_t lanes[GROUPS];
+                for (size_t g = 0; g < GROUPS; ++g) lanes[g] = base[g * stages * 16 * 48 + bit];
+                std::memcpy(&out[bit], lanes, sizeof(Slice));
+            }
+        }
+    };
+    template<typename Slice, typename Keys>
+    [[gnu::always_inline]] static inline void cryptBatch(const uint64_t* src, uint64_t* dst, const Keys& keys) {
+        Slice input[64];
+        load(src, input);
+        Slice halves[2][32];
+        for (size_t i = 0; i < 32; ++i) {
+            halves[0][i] = input[IP_TABLE[i] - 1];
+            halves[1][i] = input[IP_TABLE[32 + i] - 1];
+        }
+        Slice* left = halves[0];
+        Slice* right = halves[1];
+        Slice keyMasks[48];
+        for (size_t stage = 0; stage < keys.stageCount(); ++stage) {
+            for (size_t round = 0; round < 16; ++round) {
+                keys.load(stage, round, keyMasks);
+                feistelRound(left, right, keyMasks, std::make_index_sequence<8>{});
+                std::swap(left, right);
+            }
+            std::swap(left, right);
+        }
+        Slice preOutput[64];
+        for (size_t i = 0; i < 32; ++i) {
+            preOutput[i] = left[i];
+            preOutput[32 + i] = right[i];
+        }
+        Slice output[64];
+        for (size_t i = 0; i < 64; ++i) output[i] = preOutput[FP_TABLE[i] - 1];
+        store(output, dst);
+    }
+    template<typename Keys>
+    using BatchKernel = void(*)(const uint64_t*, uint64_t*, const Keys&);
+    template<typename Keys>
+    static void cryptBatch64(const uint64_t* src, uint64_t* dst, const Keys& keys) {
+        cryptBatch<uint64_t>(src, dst, keys);
+    }
+    template<typename Keys>
+    static void cryptBatch128(const uint64_t* src, uint64_t* dst, const Keys& keys) {
+        cryptBatch<Slice128>(src, dst, keys);
+    }
+#if defined(__x86_64__) || defined(__i386__)
+    template<typename Keys>
+    __attribute__((target("avx2"))) static void cryptBatch256(const uint64_t* src, uint64_t* dst, const Keys& keys) {
+        cryptBatch<Slice256>(src, dst, keys);
+    }
+    template<typename Keys>
+    __attribute__((target("avx512f"))) static void cryptBatch512(const uint64_t* src, uint64_t* dst, const Keys& keys) {
+        cryptBatch<Slice512>(src, dst, keys);
+    }
+#endif
+    template<typename Keys>
+    struct Width {
+        size_t lanes;
+        BatchKernel<Keys> kernel;
+    };
+    template<typename Keys>
+    static Width<Keys> widthFor(SimdLevel level) {
+        switch (level) {
+#if defined(__x86_64__) || defined(__i386__)
+            case SimdLevel::AVX512:
+            case SimdLevel::AVX512VBMI: return {512, cryptBatch512<Keys>};
+            case SimdLevel::AVX2: return {256, cryptBatch256<Keys>};
+            case SimdLevel::SSSE3: return {128, cryptBatch128<Keys>};
+#endif
+            default: return {64, cryptBatch64<Keys>};
+        }
+    }
+    template<typename Keys>
+    static void cryptWords(const uint64_t* src, uint64_t* dst, size_t nBlocks, const Keys& keys) {
+        size_t i = 0;
+        for (SimdLevel level = CpuFeatures::active();; level = static_cast<SimdLevel>(static_cast<int>(level) - 1)) {
+            Width<Keys> width = widthFor<Keys>(level);
+            for (; i + width.lanes <= nBlocks; i += width.lanes) width.kernel(src + i, dst + i, keys.advance(i / 64));
+            if (level == SimdLevel::Scalar) break;
+        }
+    }
+    template<typename Keys>
+    static void cryptBytes(const Byte* src, Byte* dst, size_t nBlocks, const Keys& keys) {
+        uint64_t words[MAX_LANES];
+        for (size_t i = 0; i < nBlocks; i += MAX_LANES) {
+            size_t count = std::min(MAX_LANES, nBlocks - i);
+            for (size_t b = 0; b < count; ++b) words[b] = BitUtils::bytesToUInt64(std::span{src + (i + b) * 8, 8});
+            cryptWords(words, words, count, keys.advance(i / 64));
+            for (size_t b = 0; b < count; ++b) BitUtils::uint64ToBytes(words[b], std::span{dst + (i + b) * 8, 8});
+        }
+    }
+    BitslicedDES::LaneKeys::LaneKeys(std::span<const Stage> laneStages, size_t stagesPerLane)
+        : stages(stagesPerLane), laneCount(stagesPerLane == 0 ? 0 : laneStages.size() / stagesPerLane / 64 * 64)
+    {
+        if (stagesPerLane == 0 || laneStages.size() % stagesPerLane != 0) {
+            throw std::invalid_argument("Lane stages must be a whole number of lanes");
+        }
+        masks.resize(laneCount / 64 * stages * 16 * 48);
+        uint64_t* out = masks.data();
+        for (size_t group = 0; group < laneCount; group += 64) {
+            for (size_t stage = 0; stage < stages; ++stage) {
+                for (size_t round = 0; round < 16; ++round) {
+                    uint64_t a[64];
+                    for (size_t lane = 0; lane < 64; ++lane) {
+                        const Stage& s = laneStages[(group + lane) * stages + stage];
+                        a[lane] = (*s.keys)[s.decrypt ? 15 - round : round] << 16;
+                    }
+                    transpose64(a);
+                    std::copy_n(a, 48, out);
+                    out += 48;
+                }
+            }
+        }
+    }
+    size_t BitslicedDES::lanes() {
+        return widthFor<UniformKeys>(CpuFeatures::active()).lanes;
+    }
+    void BitslicedDES::crypt(const uint64_t* src, uint64_t* dst, size_t nBlocks, std::span<const Stage> stages) {
+        if (nBlocks % 64 != 0) throw std::invalid_argument("Bitsliced DES needs a multiple of 64 blocks");
+        cryptWords(src, dst, nBlocks, UniformKeys{stages});
+    }
+    void BitslicedDES::crypt(const Byte* src, Byte* dst, size_t nBlocks, std::span<const Stage> stages) {
+        if (nBlocks % 64 != 0) throw std::invalid_argument("Bitsliced DES needs a multiple of 64 blocks");
+        cryptBytes(src, dst, nBlocks, UniformKeys{stages});
+    }
+    void BitslicedDES::crypt(const Byte* src, Byte* dst, size_t nBlocks, const LaneKeys& keys) {
+        if (nBlocks % 64 != 0 || nBlocks > keys.lanes()) {
+            throw std::invalid_argument("Bitsliced DES needs a multiple of 64 blocks covered by the lane keys");
+        }
+        cryptBytes(src, dst, nBlocks, SlicedKeys{keys.masks.data(), keys.stages});
+    }
+}
\ No newline at end of file
@@ -1,42 +1,66 @@
 #include "crypto/symmetric/DEAL.hpp"
+#include "crypto/symmetric/BitslicedDES.hpp"
 #include <stdexcept>
 #include <algorithm>
 namespace crypto::symmetric {
+    using utils::BitUtils;
     DEAL::DEAL(ConstBytesSpan key) {
         if (key.size() != 16) throw std::invalid_argument("DEAL-128 requires 16 bytes key");
-        for(int i=0; i<6; ++i) {
+        for (size_t i = 0; i < ROUNDS; ++i) {
              size_t offset = (i % 2) * 8;
-             roundDes.push_back(std::make_unique<DES>(key.subspan(offset, 8)));
+             roundKeys[i] = DES::expandKey(BitUtils::bytesToUInt64(key.subspan(offset, 8)));
         }
     }
-    void DEAL::encryptBlock(ConstBytesSpan src, BytesSpan dst) {
+    void DEAL::cryptBlock(ConstBytesSpan src, BytesSpan dst, bool decrypt) const {
         if (src.size() != 16 || dst.size() != 16) throw std::invalid_argument("DEAL block size is 16");
-        Bytes left(src.begin(), src.begin() + 8);
-        Bytes right(src.begin() + 8, src.begin() + 16);
-        for (int i = 0; i < 6; ++i) {
-            Bytes temp = right;
-            Bytes f_out(8);
-            roundDes[i]->encryptBlock(right, f_out);
-            for(int j=0; j<8; ++j) right[j] = left[j] ^ f_out[j];
+        uint64_t left = BitUtils::bytesToUInt64(src.subspan(0, 8));
+        uint64_t right = BitUtils::bytesToUInt64(src.subspan(8, 8));
+        for (size_t i = 0; i < ROUNDS; ++i) {
+            uint64_t temp = right;
+            right = left ^ DES::crypt(right, roundKeys[decrypt ? ROUNDS - 1 - i : i], false);
             left = temp;
         }
-        std::swap(left, right);
-        std::copy(left.begin(), left.end(), dst.begin());
-        std::copy(right.begin(), right.end(), dst.begin() + 8);
+        BitUtils::uint64ToBytes(right, dst.subspan(0, 8));
+        BitUtils::uint64ToBytes(left, dst.subspan(8, 8));
+    }
+    void DEAL::encryptBlock(ConstBytesSpan src, BytesSpan dst) {
+        cryptBlock(src, dst, false);
     }
     void DEAL::decryptBlock(ConstBytesSpan src, BytesSpan dst) {
-        if (src.size() != 16 || dst.size() != 16) throw std::invalid_argument("DEAL block size is 16");
-        Bytes left(src.begin(), src.begin() + 8);
-        Bytes right(src.begin() + 8, src.begin() + 16);
-        for (int i = 5; i >= 0; --i) {
-             Bytes temp = right;
-             Bytes f_out(8);
-             roundDes[i]->encryptBlock(right, f_out);
-             for(int j=0; j<8; ++j) right[j] = left[j] ^ f_out[j];
-             left = temp;
+        cryptBlock(src, dst, true);
+    }
+    void DEAL::encryptBlocks(ConstBytesSpan src, BytesSpan dst, size_t nBlocks) {
+        cryptBlocks(src, dst, nBlocks, false);
+    }
+    void DEAL::decryptBlocks(ConstBytesSpan src, BytesSpan dst, size_t nBlocks) {
+        cryptBlocks(src, dst, nBlocks, true);
+    }
+    void DEAL::cryptBlocks(ConstBytesSpan src, BytesSpan dst, size_t nBlocks, bool decrypt) const {
+        if (src.size() < nBlocks * 16 || dst.size() < nBlocks * 16) throw std::invalid_argument("DEAL block size is 16");
+        std::array<uint64_t, CHUNK_BLOCKS> leftHalves, rightHalves, f_out;
+        for (size_t first = 0; first < nBlocks; first += CHUNK_BLOCKS) {
+            size_t count = std::min(CHUNK_BLOCKS, nBlocks - first);
+            size_t bulk = count / 64 * 64;
+            uint64_t* left = leftHalves.data();
+            uint64_t* right = rightHalves.data();
+            for (size_t i = 0; i < count; ++i) {
+                left[i] = BitUtils::bytesToUInt64(src.subspan((first + i) * 16, 8));
+                right[i] = BitUtils::bytesToUInt64(src.subspan((first + i) * 16 + 8, 8));
+            }
+            for (size_t r = 0; r < ROUNDS; ++r) {
+                const auto& keys = roundKeys[decrypt ? ROUNDS - 1 - r : r];
+                if (bulk > 0) {
+                    const BitslicedDES::Stage stage{&keys, false};
+                    BitslicedDES::crypt(right, f_out.data(), bulk, {&stage, 1});
+                }
+                for (size_t i = bulk; i < count; ++i) f_out[i] = DES::crypt(right[i], keys, false);
+                for (size_t i = 0; i < count; ++i) left[i] ^= f_out[i];
+                std::swap(left, right);
+            }
+            for (size_t i = 0; i < count; ++i) {
+                BitUtils::uint64ToBytes(right[i], dst.subspan((first + i) * 16, 8));
+                BitUtils::uint64ToBytes(left[i], dst.subspan((first + i) * 16 + 8, 8));
+            }
         }
-        std::swap(left, right);
-        std::copy(left.begin(), left.end(), dst.begin());
-        std::copy(right.begin(), right.end(), dst.begin() + 8);
     }
 }
\ No newline at end of file
@@ -1,9 +1,11 @@
 #include "crypto/symmetric/FROG.hpp"
+#include "crypto/symmetric/FROGKernels.hpp"
+#include "crypto/utils/CpuFeatures.hpp"
 #include <stdexcept>
 #include <cstring>
 #include <vector>
 namespace crypto::symmetric {
-    FROG::FROG(ConstBytesSpan key) {
+    FROG::FROG(ConstBytesSpan key, KeyLayout layout) {
         if (key.size() < 5 || key.size() > 125) {
             throw std::invalid_argument("FROG key must be between 5 and 125 bytes");
         }
@@ -11,6 +13,7 @@ namespace crypto::symmetric {
         decryptKeys.resize(NUM_ROUNDS);
         makeInternalKey(key);
         invertKeys();
+        if (layout == KeyLayout::Expanded) expandKeys();
     }
     void FROG::makeInternalKey(ConstBytesSpan userKey) {
         std::vector<uint8_t> simpleKey(INTERNAL_KEY_SIZE);
@@ -77,34 +80,78 @@ namespace crypto::symmetric {
             dk.bombPerm = ek.bombPerm;
         }
     }
+    void FROG::expandKeys() {
+        expandedEncrypt.resize(NUM_ROUNDS);
+        expandedDecrypt.resize(NUM_ROUNDS);
+        for (size_t r = 0; r < NUM_ROUNDS; ++r) {
+            const auto& ek = encryptKeys[r];
+            const auto& dk = decryptKeys[r];
+            for (size_t i = 0; i < BLOCK_SIZE; ++i) {
+                for (size_t v = 0; v < 256; ++v) {
+                    expandedEncrypt[r].table[i][v] = ek.subst[v ^ ek.xorBu[i]];
+                    expandedDecrypt[r].table[i][v] = dk.subst[v] ^ dk.xorBu[i];
+                }
+            }
+        }
+    }
+    struct KernelSet {
+        frog_kernels::Kernel encrypt;
+        frog_kernels::Kernel decrypt;
+        bool vectorized;
+    };
+    static KernelSet kernels() {
+        switch (utils::CpuFeatures::active()) {
+#if defined(__x86_64__) || defined(__i386__)
+            case utils::SimdLevel::AVX512VBMI: return {frog_kernels::encryptAVX512VBMI, frog_kernels::decryptAVX512VBMI, true};
+            case utils::SimdLevel::AVX512:
+            case utils::SimdLevel::AVX2: return {frog_kernels::encryptAVX2, frog_kernels::decryptAVX2, true};
+            case utils::SimdLevel::SSSE3: return {frog_kernels::encryptSSSE3, frog_kernels::decryptSSSE3, true};
+#endif
+            default: return {frog_kernels::encryptScalar, frog_kernels::decryptScalar, false};
+        }
+    }
+    void FROG::encryptRaw(uint8_t* blocks, size_t nBlocks) const {
+        KernelSet selected = kernels();
+        if (!expandedEncrypt.empty() && (nBlocks == 1 || !selected.vectorized)) {
+            frog_kernels::encryptExpanded(expandedEncrypt.data(), blocks, nBlocks);
+        } else if (nBlocks == 1) {
+            frog_kernels::encryptScalar(encryptKeys.data(), blocks, 1);
+        } else {
+            selected.encrypt(encryptKeys.data(), blocks, nBlocks);
+        }
+    }
+    void FROG::decryptRaw(uint8_t* blocks, size_t nBlocks) const {
+        KernelSet selected = kernels();
+        if (!expandedDecrypt.empty() && (nBlocks == 1 || !selected.vectorized)) {
+            frog_kernels::decryptExpanded(expandedDecrypt.data(), blocks, nBlocks);
+        } else if (nBlocks == 1) {
+            frog_kernels::decryptScalar(decryptKeys.data(), blocks, 1);
+        } else {
+            selected.decrypt(decryptKeys.data(), blocks, nBlocks);
+        }
+    }
     void FROG::encryptBlock(ConstBytesSpan src, BytesSpan dst) {
         if (src.size() != BLOCK_SIZE || dst.size() != BLOCK_SIZE)
              throw std::invalid_argument("Size error");
-        std::memcpy(dst.data(), src.data(), BLOCK_SIZE);
-        uint8_t* block = reinterpret_cast<uint8_t*>(dst.data());
-        for (int r = 0; r < NUM_ROUNDS; ++r) {
-            const auto& key = encryptKeys[r];
-            for (int i = 0; i < 16; ++i) block[i] ^= key.xorBu[i];
-            for (int i = 0; i < 16; ++i) block[i] = key.subst[block[i]];
-            for (int i = 0; i < 15; ++i) {
-                block[i+1] ^= block[i];
-            }
-             block[0] ^= block[15];
-        }
+        std::memmove(dst.data(), src.data(), BLOCK_SIZE);
+        encryptRaw(reinterpret_cast<uint8_t*>(dst.data()), 1);
     }
     void FROG::decryptBlock(ConstBytesSpan src, BytesSpan dst) {
         if (src.size() != BLOCK_SIZE || dst.size() != BLOCK_SIZE)
              throw std::invalid_argument("Size error");
-        std::memcpy(dst.data(), src.data(), BLOCK_SIZE);
-        uint8_t* block = reinterpret_cast<uint8_t*>(dst.data());
-        for (int r = 0; r < NUM_ROUNDS; ++r) {
-            const auto& key = decryptKeys[r];
-            block[0] ^= block[15];
-            for (int i = 14; i >= 0; --i) {
-                block[i+1] ^= block[i];
-            }
-            for (int i = 0; i < 16; ++i) block[i] = key.subst[block[i]];
-            for (int i = 0; i < 16; ++i) block[i] ^= key.xorBu[i];
-        }
+        std::memmove(dst.data(), src.data(), BLOCK_SIZE);
+        decryptRaw(reinterpret_cast<uint8_t*>(dst.data()), 1);
+    }
+    void FROG::encryptBlocks(ConstBytesSpan src, BytesSpan dst, size_t nBlocks) {
+        if (src.size() < nBlocks * BLOCK_SIZE || dst.size() < nBlocks * BLOCK_SIZE)
+             throw std::invalid_argument("Size error");
+        std::memmove(dst.data(), src.data(), nBlocks * BLOCK_SIZE);
+        encryptRaw(reinterpret_cast<uint8_t*>(dst.data()), nBlocks);
+    }
+    void FROG::decryptBlocks(ConstBytesSpan src, BytesSpan dst, size_t nBlocks) {
+        if (src.size() < nBlocks * BLOCK_SIZE || dst.size() < nBlocks * BLOCK_SIZE)
+             throw std::invalid_argument("Size error");
+        std::memmove(dst.data(), src.data(), nBlocks * BLOCK_SIZE);
+        decryptRaw(reinterpret_cast<uint8_t*>(dst.data()), nBlocks);
     }
 }
\ No newline at end of file
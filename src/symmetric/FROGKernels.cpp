@@ -0,0 +1,223 @@
+#include "crypto/symmetric/FROGKernels.hpp"
+#include <cstring>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+namespace crypto::symmetric::frog_kernels {
+    static constexpr size_t ROUNDS = FROG::NUM_ROUNDS;
+    void encryptScalar(const FROG::RoundKey* keys, uint8_t* blocks, size_t nBlocks) {
+        for (size_t b = 0; b < nBlocks; ++b) {
+            uint8_t* block = blocks + b * 16;
+            for (size_t r = 0; r < ROUNDS; ++r) {
+                const auto& key = keys[r];
+                for (int i = 0; i < 16; ++i) block[i] ^= key.xorBu[i];
+                for (int i = 0; i < 16; ++i) block[i] = key.subst[block[i]];
+                for (int i = 0; i < 15; ++i) {
+                    block[i+1] ^= block[i];
+                }
+                block[0] ^= block[15];
+            }
+        }
+    }
+    void decryptScalar(const FROG::RoundKey* keys, uint8_t* blocks, size_t nBlocks) {
+        for (size_t b = 0; b < nBlocks; ++b) {
+            uint8_t* block = blocks + b * 16;
+            for (size_t r = 0; r < ROUNDS; ++r) {
+                const auto& key = keys[r];
+                block[0] ^= block[15];
+                for (int i = 14; i >= 0; --i) {
+                    block[i+1] ^= block[i];
+                }
+                for (int i = 0; i < 16; ++i) block[i] = key.subst[block[i]];
+                for (int i = 0; i < 16; ++i) block[i] ^= key.xorBu[i];
+            }
+        }
+    }
+    void encryptExpanded(const FROG::ExpandedRound* rounds, uint8_t* blocks, size_t nBlocks) {
+        for (size_t b = 0; b < nBlocks; ++b) {
+            uint8_t* block = blocks + b * 16;
+            for (size_t r = 0; r < ROUNDS; ++r) {
+                const auto& table = rounds[r].table;
+                for (int i = 0; i < 16; ++i) block[i] = table[i][block[i]];
+                for (int i = 0; i < 15; ++i) {
+                    block[i+1] ^= block[i];
+                }
+                block[0] ^= block[15];
+            }
+        }
+    }
+    void decryptExpanded(const FROG::ExpandedRound* rounds, uint8_t* blocks, size_t nBlocks) {
+        for (size_t b = 0; b < nBlocks; ++b) {
+            uint8_t* block = blocks + b * 16;
+            for (size_t r = 0; r < ROUNDS; ++r) {
+                const auto& table = rounds[r].table;
+                block[0] ^= block[15];
+                for (int i = 14; i >= 0; --i) {
+                    block[i+1] ^= block[i];
+                }
+                for (int i = 0; i < 16; ++i) block[i] = table[i][block[i]];
+            }
+        }
+    }
+#if defined(__x86_64__) || defined(__i386__)
+    __attribute__((target("ssse3")))
+    static inline __m128i substSSSE3(__m128i x, const uint8_t* table) {
+        const __m128i lowMask = _mm_set1_epi8(0x0F);
+        __m128i lo = _mm_and_si128(x, lowMask);
+        __m128i hi = _mm_and_si128(_mm_srli_epi16(x, 4), lowMask);
+        __m128i res = _mm_setzero_si128();
+        for (int k = 0; k < 16; ++k) {
+            __m128i row = _mm_loadu_si128(reinterpret_cast<const __m128i*>(table + 16 * k));
+            __m128i hit = _mm_cmpeq_epi8(hi, _mm_set1_epi8(static_cast<char>(k)));
+            res = _mm_or_si128(res, _mm_and_si128(hit, _mm_shuffle_epi8(row, lo)));
+        }
+        return res;
+    }
+    __attribute__((target("ssse3")))
+    void encryptSSSE3(const FROG::RoundKey* keys, uint8_t* blocks, size_t nBlocks) {
+        for (size_t b = 0; b < nBlocks; ++b) {
+            auto* ptr = reinterpret_cast<__m128i*>(blocks + b * 16);
+            __m128i x = _mm_loadu_si128(ptr);
+            for (size_t r = 0; r < ROUNDS; ++r) {
+                x = _mm_xor_si128(x, _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys[r].xorBu.data())));
+                x = substSSSE3(x, keys[r].subst.data());
+                x = _mm_xor_si128(x, _mm_slli_si128(x, 1));
+                x = _mm_xor_si128(x, _mm_slli_si128(x, 2));
+                x = _mm_xor_si128(x, _mm_slli_si128(x, 4));
+                x = _mm_xor_si128(x, _mm_slli_si128(x, 8));
+                x = _mm_xor_si128(x, _mm_srli_si128(x, 15));
+            }
+            _mm_storeu_si128(ptr, x);
+        }
+    }
+    __attribute__((target("ssse3")))
+    void decryptSSSE3(const FROG::RoundKey* keys, uint8_t* blocks, size_t nBlocks) {
+        for (size_t b = 0; b < nBlocks; ++b) {
+            auto* ptr = reinterpret_cast<__m128i*>(blocks + b * 16);
+            __m128i x = _mm_loadu_si128(ptr);
+            for (size_t r = 0; r < ROUNDS; ++r) {
+                x = _mm_xor_si128(x, _mm_srli_si128(x, 15));
+                x = _mm_xor_si128(x, _mm_slli_si128(x, 1));
+                x = substSSSE3(x, keys[r].subst.data());
+                x = _mm_xor_si128(x, _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys[r].xorBu.data())));
+            }
+            _mm_storeu_si128(ptr, x);
+        }
+    }
+    __attribute__((target("avx2")))
+    static inline __m256i substAVX2(__m256i x, const uint8_t* table) {
+        __m256i lo = _mm256_and_si256(x, _mm256_set1_epi8(0x0F));
+        __m256i v[16];
+        for (int k = 0; k < 16; ++k) {
+            __m128i row = _mm_loadu_si128(reinterpret_cast<const __m128i*>(table + 16 * k));
+            v[k] = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(row), lo);
+        }
+        for (int bit = 4, width = 8; bit < 8; ++bit, width >>= 1) {
+            __m256i select = _mm256_slli_epi16(x, 7 - bit);
+            for (int k = 0; k < width; ++k) v[k] = _mm256_blendv_epi8(v[2 * k], v[2 * k + 1], select);
+        }
+        return v[0];
+    }
+    __attribute__((target("avx2")))
+    void encryptAVX2(const FROG::RoundKey* keys, uint8_t* blocks, size_t nBlocks) {
+        size_t b = 0;
+        for (; b + 2 <= nBlocks; b += 2) {
+            auto* ptr = reinterpret_cast<__m256i*>(blocks + b * 16);
+            __m256i x = _mm256_loadu_si256(ptr);
+            for (size_t r = 0; r < ROUNDS; ++r) {
+                __m128i xorBu = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys[r].xorBu.data()));
+                x = _mm256_xor_si256(x, _mm256_broadcastsi128_si256(xorBu));
+                x = substAVX2(x, keys[r].subst.data());
+                x = _mm256_xor_si256(x, _mm256_slli_si256(x, 1));
+                x = _mm256_xor_si256(x, _mm256_slli_si256(x, 2));
+                x = _mm256_xor_si256(x, _mm256_slli_si256(x, 4));
+                x = _mm256_xor_si256(x, _mm256_slli_si256(x, 8));
+                x = _mm256_xor_si256(x, _mm256_srli_si256(x, 15));
+            }
+            _mm256_storeu_si256(ptr, x);
+        }
+        encryptSSSE3(keys, blocks + b * 16, nBlocks - b);
+    }
+    __attribute__((target("avx2")))
+    void decryptAVX2(const FROG::RoundKey* keys, uint8_t* blocks, size_t nBlocks) {
+        size_t b = 0;
+        for (; b + 2 <= nBlocks; b += 2) {
+            auto* ptr = reinterpret_cast<__m256i*>(blocks + b * 16);
+            __m256i x = _mm256_loadu_si256(ptr);
+            for (size_t r = 0; r < ROUNDS; ++r) {
+                __m128i xorBu = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys[r].xorBu.data()));
+                x = _mm256_xor_si256(x, _mm256_srli_si256(x, 15));
+                x = _mm256_xor_si256(x, _mm256_slli_si256(x, 1));
+                x = substAVX2(x, keys[r].subst.data());
+                x = _mm256_xor_si256(x, _mm256_broadcastsi128_si256(xorBu));
+            }
+            _mm256_storeu_si256(ptr, x);
+        }
+        decryptSSSE3(keys, blocks + b * 16, nBlocks - b);
+    }
+    __attribute__((target("avx512f,avx512bw,avx512vbmi")))
+    static inline void broadcastXorBuAVX512(const FROG::RoundKey* keys, __m512i* xorBu) {
+        for (size_t r = 0; r < ROUNDS; ++r) {
+            int32_t words[4];
+            std::memcpy(words, keys[r].xorBu.data(), sizeof(words));
+            xorBu[r] = _mm512_set4_epi32(words[3], words[2], words[1], words[0]);
+        }
+    }
+    __attribute__((target("avx512f,avx512bw,avx512vbmi")))
+    static inline __m512i substAVX512VBMI(__m512i x, const uint8_t* table) {
+        __m512i t0 = _mm512_loadu_si512(table);
+        __m512i t1 = _mm512_loadu_si512(table + 64);
+        __m512i t2 = _mm512_loadu_si512(table + 128);
+        __m512i t3 = _mm512_loadu_si512(table + 192);
+        __m512i lower = _mm512_permutex2var_epi8(t0, x, t1);
+        __m512i upper = _mm512_permutex2var_epi8(t2, x, t3);
+        return _mm512_mask_blend_epi8(_mm512_movepi8_mask(x), lower, upper);
+    }
+    __attribute__((target("avx512f,avx512bw,avx512vbmi")))
+    void encryptAVX512VBMI(const FROG::RoundKey* keys, uint8_t* blocks, size_t nBlocks) {
+        __m512i xorBu[ROUNDS];
+        broadcastXorBuAVX512(keys, xorBu);
+        size_t b = 0;
+        for (; b + 4 <= nBlocks; b += 4) {
+            uint8_t* ptr = blocks + b * 16;
+            __m512i x = _mm512_loadu_si512(ptr);
+            for (size_t r = 0; r < ROUNDS; ++r) {
+                x = _mm512_xor_si512(x, xorBu[r]);
+                x = substAVX512VBMI(x, keys[r].subst.data());
+                x = _mm512_xor_si512(x, _mm512_bslli_epi128(x, 1));
+                x = _mm512_xor_si512(x, _mm512_bslli_epi128(x, 2));
+                x = _mm512_xor_si512(x, _mm512_bslli_epi128(x, 4));
+                x = _mm512_xor_si512(x, _mm512_bslli_epi128(x, 8));
+                x = _mm512_xor_si512(x, _mm512_bsrli_epi128(x, 15));
+            }
+            _mm512_storeu_si512(ptr, x);
+        }
+        encryptAVX2(keys, blocks + b * 16, nBlocks - b);
+    }
+    __attribute__((target("avx512f,avx512bw,avx512vbmi")))
+    void decryptAVX512VBMI(const FROG::RoundKey* keys, uint8_t* blocks, size_t nBlocks) {
+        __m512i xorBu[ROUNDS];
+        broadcastXorBuAVX512(keys, xorBu);
+        size_t b = 0;
+        for (; b + 4 <= nBlocks; b += 4) {
+            uint8_t* ptr = blocks + b * 16;
+            __m512i x = _mm512_loadu_si512(ptr);
+            for (size_t r = 0; r < ROUNDS; ++r) {
+                x = _mm512_xor_si512(x, _mm512_bsrli_epi128(x, 15));
+                x = _mm512_xor_si512(x, _mm512_bslli_epi128(x, 1));
+                x = substAVX512VBMI(x, keys[r].subst.data());
+                x = _mm512_xor_si512(x, xorBu[r]);
+            }
+            _mm512_storeu_si512(ptr, x);
+        }
+        decryptAVX2(keys, blocks + b * 16, nBlocks - b);
+    }
+#else
+    void encryptSSSE3(const FROG::RoundKey* keys, uint8_t* blocks, size_t nBlocks) { encryptScalar(keys, blocks, nBlocks); }
+    void decryptSSSE3(const FROG::RoundKey* keys, uint8_t* blocks, size_t nBlocks) { decryptScalar(keys, blocks, nBlocks); }
+    void encryptAVX2(const FROG::RoundKey* keys, uint8_t* blocks, size_t nBlocks) { encryptScalar(keys, blocks, nBlocks); }
+    void decryptAVX2(const FROG::RoundKey* keys, uint8_t* blocks, size_t nBlocks) { decryptScalar(keys, blocks, nBlocks); }
+    void encryptAVX512VBMI(const FROG::RoundKey* keys, uint8_t* blocks, size_t nBlocks) { encryptScalar(keys, blocks, nBlocks); }
+    void decryptAVX512VBMI(const FROG::RoundKey* keys, uint8_t* blocks, size_t nBlocks) { decryptScalar(keys, blocks, nBlocks); }
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#include "crypto/symmetric/TripleDES.hpp"
+#include "crypto/utils/BitUtils.hpp"
+namespace crypto::symmetric {
+    using utils::BitUtils;
+    template<size_t Lanes>
+    static void cryptLanes(const Byte* src, Byte* dst, std::span<const BitslicedDES::Stage> plan) {
+        std::array<uint64_t, Lanes> state;
+        for (size_t l = 0; l < Lanes; ++l) {
+            state[l] = DES::initialPermutation(BitUtils::bytesToUInt64(std::span{src + l * 8, 8}));
+        }
+        for (const auto& stage : plan) {
+            DES::rounds(state, *stage.keys, stage.decrypt);
+        }
+        for (size_t l = 0; l < Lanes; ++l) {
+            BitUtils::uint64ToBytes(DES::finalPermutation(state[l]), std::span{dst + l * 8, 8});
+        }
+    }
+    std::array<BitslicedDES::Stage, 3> TripleDES::stages(bool decrypt) const {
+        if (decrypt) {
+            return {{{&des3.keySchedule(), true}, {&des2.keySchedule(), false}, {&des1.keySchedule(), true}}};
+        }
+        return {{{&des1.keySchedule(), false}, {&des2.keySchedule(), true}, {&des3.keySchedule(), false}}};
+    }
+    void TripleDES::cryptBlocks(ConstBytesSpan src, BytesSpan dst, size_t nBlocks, bool decrypt) const {
+        if (src.size() < nBlocks * 8 || dst.size() < nBlocks * 8) throw std::invalid_argument("3DES block size is 8");
+        const auto plan = stages(decrypt);
+        size_t i = nBlocks / 64 * 64;
+        if (i > 0) {
+            BitslicedDES::crypt(src.data(), dst.data(), i, plan);
+        }
+        for (; i + 4 <= nBlocks; i += 4) {
+            cryptLanes<4>(src.data() + i * 8, dst.data() + i * 8, plan);
+        }
+        for (; i < nBlocks; ++i) {
+            cryptLanes<1>(src.data() + i * 8, dst.data() + i * 8, plan);
+        }
+    }
+    void TripleDES::encryptBlock(ConstBytesSpan src, BytesSpan dst) {
+        cryptBlocks(src, dst, 1, false);
+    }
+    void TripleDES::decryptBlock(ConstBytesSpan src, BytesSpan dst) {
+        cryptBlocks(src, dst, 1, true);
+    }
+    void TripleDES::encryptBlocks(ConstBytesSpan src, BytesSpan dst, size_t nBlocks) {
+        cryptBlocks(src, dst, nBlocks, false);
+    }
+    void TripleDES::decryptBlocks(ConstBytesSpan src, BytesSpan dst, size_t nBlocks) {
+        cryptBlocks(src, dst, nBlocks, true);
+    }
+}
\ No newline at end of file
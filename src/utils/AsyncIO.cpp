@@ -0,0 +1,221 @@
+#include "crypto/utils/AsyncIO.hpp"
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#ifdef CRYPTO_HAVE_LIBURING
+#include <liburing.h>
+#include <sys/uio.h>
+#endif
+namespace crypto::utils {
+    namespace {
+        constexpr size_t MAX_WORKERS = 8;
+        void checkSlot(std::span<const BytesSpan> buffers, size_t slot, size_t length) {
+            if (slot >= buffers.size()) throw std::out_of_range("Unknown I/O buffer slot");
+            if (length > buffers[slot].size()) throw std::out_of_range("I/O request exceeds its buffer");
+        }
+        class ThreadPoolIO final : public AsyncIO {
+            struct Request {
+                bool write;
+                int fd;
+                size_t slot;
+                size_t length;
+                uint64_t offset;
+            };
+            std::vector<BytesSpan> buffers;
+            std::deque<Request> pending;
+            std::deque<Completion> completed;
+            size_t outstanding = 0;
+            bool stopping = false;
+            std::mutex mutex;
+            std::condition_variable requested;
+            std::condition_variable finished;
+            std::vector<std::thread> workers;
+            int64_t transfer(const Request& request) {
+                Byte* data = buffers[request.slot].data();
+                size_t done = 0;
+                while (done < request.length) {
+                    off_t position = static_cast<off_t>(request.offset + done);
+                    ssize_t n = request.write
+                        ? ::pwrite(request.fd, data + done, request.length - done, position)
+                        : ::pread(request.fd, data + done, request.length - done, position);
+                    if (n < 0) {
+                        if (errno == EINTR) continue;
+                        return -errno;
+                    }
+                    if (n == 0) break;
+                    done += static_cast<size_t>(n);
+                }
+                return static_cast<int64_t>(done);
+            }
+            void serve() {
+                while (true) {
+                    Request request;
+                    {
+                        std::unique_lock lock(mutex);
+                        requested.wait(lock, [&] { return stopping || !pending.empty(); });
+                        if (stopping) return;
+                        request = pending.front();
+                        pending.pop_front();
+                    }
+                    int64_t result = transfer(request);
+                    {
+                        std::lock_guard lock(mutex);
+                        completed.push_back({request.slot, result});
+                    }
+                    finished.notify_one();
+                }
+            }
+            void submit(const Request& request) {
+                checkSlot(buffers, request.slot, request.length);
+                {
+                    std::lock_guard lock(mutex);
+                    pending.push_back(request);
+                    ++outstanding;
+                }
+                requested.notify_one();
+            }
+        public:
+            ThreadPoolIO(std::span<const BytesSpan> buffers_, size_t queueDepth) : buffers(buffers_.begin(), buffers_.end()) {
+                size_t count = std::clamp<size_t>(queueDepth, 1, MAX_WORKERS);
+                for (size_t i = 0; i < count; ++i) workers.emplace_back([this] { serve(); });
+            }
+            ~ThreadPoolIO() override {
+                {
+                    std::lock_guard lock(mutex);
+                    stopping = true;
+                    pending.clear();
+                }
+                requested.notify_all();
+                for (auto& worker : workers) worker.join();
+            }
+            void submitRead(int fd, size_t slot, size_t length, uint64_t offset) override {
+                submit({false, fd, slot, length, offset});
+            }
+            void submitWrite(int fd, size_t slot, size_t length, uint64_t offset) override {
+                submit({true, fd, slot, length, offset});
+            }
+            Completion wait() override {
+                std::unique_lock lock(mutex);
+                if (outstanding == 0) throw std::logic_error("No I/O in flight");
+                finished.wait(lock, [&] { return !completed.empty(); });
+                Completion completion = completed.front();
+                completed.pop_front();
+                --outstanding;
+                return completion;
+            }
+            const char* name() const override { return "thread-pool"; }
+        };
+#ifdef CRYPTO_HAVE_LIBURING
+        class UringIO final : public AsyncIO {
+            struct Request {
+                bool write = false;
+                int fd = -1;
+                size_t length = 0;
+                uint64_t offset = 0;
+                size_t done = 0;
+            };
+            io_uring ring{};
+            std::vector<BytesSpan> buffers;
+            std::vector<Request> requests;
+            bool registered = false;
+            size_t inFlight = 0;
+            void queue(size_t slot) {
+                Request& request = requests[slot];
+                io_uring_sqe* sqe = io_uring_get_sqe(&ring);
+                if (!sqe) throw std::runtime_error("io_uring submission queue is full");
+                Byte* data = buffers[slot].data() + request.done;
+                auto length = static_cast<unsigned>(request.length - request.done);
+                uint64_t offset = request.offset + request.done;
+                if (registered && request.write) io_uring_prep_write_fixed(sqe, request.fd, data, length, offset, static_cast<int>(slot));
+                else if (registered) io_uring_prep_read_fixed(sqe, request.fd, data, length, offset, static_cast<int>(slot));
+                else if (request.write) io_uring_prep_write(sqe, request.fd, data, length, offset);
+                else io_uring_prep_read(sqe, request.fd, data, length, offset);
+                io_uring_sqe_set_data(sqe, reinterpret_cast<void*>(static_cast<uintptr_t>(slot)));
+                if (int rc = io_uring_submit(&ring); rc < 0) throw std::system_error(-rc, std::generic_category(), "io_uring_submit");
+                ++inFlight;
+            }
+            void start(bool write, int fd, size_t slot, size_t length, uint64_t offset) {
+                checkSlot(buffers, slot, length);
+                requests[slot] = {write, fd, length, offset, 0};
+                queue(slot);
+            }
+        public:
+            UringIO(std::span<const BytesSpan> buffers_, size_t queueDepth)
+                : buffers(buffers_.begin(), buffers_.end()), requests(buffers_.size())
+            {
+                auto entries = static_cast<unsigned>(std::bit_ceil(std::max<size_t>({queueDepth, buffers.size(), 1})));
+                if (int rc = io_uring_queue_init(entries, &ring, 0); rc < 0) {
+                    throw std::system_error(-rc, std::generic_category(), "io_uring_queue_init");
+                }
+                std::vector<iovec> vectors;
+                for (auto buffer : buffers) vectors.push_back({buffer.data(), buffer.size()});
+                registered = !vectors.empty() && io_uring_register_buffers(&ring, vectors.data(), static_cast<unsigned>(vectors.size())) == 0;
+            }
+            ~UringIO() override {
+                while (inFlight > 0) {
+                    io_uring_cqe* cqe = nullptr;
+                    int rc = io_uring_wait_cqe(&ring, &cqe);
+                    if (rc == -EINTR) continue;
+                    if (rc < 0) break;
+                    io_uring_cqe_seen(&ring, cqe);
+                    --inFlight;
+                }
+                if (registered) io_uring_unregister_buffers(&ring);
+                io_uring_queue_exit(&ring);
+            }
+            void submitRead(int fd, size_t slot, size_t length, uint64_t offset) override {
+                start(false, fd, slot, length, offset);
+            }
+            void submitWrite(int fd, size_t slot, size_t length, uint64_t offset) override {
+                start(true, fd, slot, length, offset);
+            }
+            Completion wait() override {
+                while (true) {
+                    if (inFlight == 0) throw std::logic_error("No I/O in flight");
+                    io_uring_cqe* cqe = nullptr;
+                    int rc = io_uring_wait_cqe(&ring, &cqe);
+                    if (rc == -EINTR) continue;
+                    if (rc < 0) throw std::system_error(-rc, std::generic_category(), "io_uring_wait_cqe");
+                    auto slot = static_cast<size_t>(reinterpret_cast<uintptr_t>(io_uring_cqe_get_data(cqe)));
+                    int result = cqe->res;
+                    io_uring_cqe_seen(&ring, cqe);
+                    --inFlight;
+                    Request& request = requests[slot];
+                    if (result == -EAGAIN || result == -EINTR) {
+                        queue(slot);
+                        continue;
+                    }
+                    if (result < 0) return {slot, result};
+                    request.done += static_cast<size_t>(result);
+                    if (result > 0 && request.done < request.length) {
+                        queue(slot);
+                        continue;
+                    }
+                    return {slot, static_cast<int64_t>(request.done)};
+                }
+            }
+            const char* name() const override { return registered ? "io_uring (registered buffers)" : "io_uring"; }
+        };
+#endif
+    }
+    std::unique_ptr<AsyncIO> AsyncIO::create(std::span<const BytesSpan> buffers, size_t queueDepth) {
+#ifdef CRYPTO_HAVE_LIBURING
+        try {
+            return std::make_unique<UringIO>(buffers, queueDepth);
+        } catch (const std::system_error&) {
+        }
+#endif
+        return createThreadPool(buffers, queueDepth);
+    }
+    std::unique_ptr<AsyncIO> AsyncIO::createThreadPool(std::span<const BytesSpan> buffers, size_t queueDepth) {
+        return std::make_unique<ThreadPoolIO>(buffers, queueDepth);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,186 @@
+#include "crypto/utils/BatchProcessor.hpp"
+#include <tbb/parallel_for_each.h>
+#include <tbb/task_arena.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+namespace crypto::utils {
+    namespace {
+        class MemoryBudget {
+            std::mutex mutex;
+            std::condition_variable released;
+            size_t capacity;
+            size_t available;
+        public:
+            explicit MemoryBudget(size_t bytes) : capacity(std::max<size_t>(bytes, 1)), available(capacity) {}
+            size_t acquire(size_t bytes) {
+                bytes = std::clamp<size_t>(bytes, 1, capacity);
+                std::unique_lock lock(mutex);
+                released.wait(lock, [&] { return available >= bytes; });
+                available -= bytes;
+                return bytes;
+            }
+            void release(size_t bytes) {
+                {
+                    std::lock_guard lock(mutex);
+                    available += bytes;
+                }
+                released.notify_all();
+            }
+        };
+        class Lease {
+            MemoryBudget& budget;
+            size_t bytes;
+        public:
+            Lease(MemoryBudget& budget_, size_t bytes_) : budget(budget_), bytes(budget_.acquire(bytes_)) {}
+            Lease(const Lease&) = delete;
+            Lease& operator=(const Lease&) = delete;
+            ~Lease() { budget.release(bytes); }
+        };
+        bool staysInside(const std::filesystem::path& relative) {
+            if (relative.empty() || relative.has_root_path()) return false;
+            return std::none_of(relative.begin(), relative.end(), [](const auto& part) { return part == ".."; });
+        }
+        std::filesystem::path defaultOutput(const std::filesystem::path& source) {
+            std::filesystem::path relative;
+            for (const auto& part : source.relative_path().lexically_normal()) {
+                if (part == ".." && relative.empty()) continue;
+                relative /= part;
+            }
+            return relative;
+        }
+    }
+    std::vector<BatchProcessor::Job> BatchProcessor::scanDirectory(const std::filesystem::path& inputRoot,
+                                                                   const std::filesystem::path& outputRoot)
+    {
+        if (!std::filesystem::is_directory(inputRoot)) {
+            throw std::runtime_error("Input directory not found: " + inputRoot.string());
+        }
+        auto outputDir = std::filesystem::weakly_canonical(outputRoot);
+        if (std::filesystem::weakly_canonical(inputRoot) == outputDir) {
+            throw std::runtime_error("Output directory must differ from input directory: " + outputRoot.string());
+        }
+        std::vector<Job> jobs;
+        std::filesystem::recursive_directory_iterator it(inputRoot), end;
+        for (; it != end; ++it) {
+            if (it->is_directory() && std::filesystem::weakly_canonical(it->path()) == outputDir) {
+                it.disable_recursion_pending();
+                continue;
+            }
+            if (!it->is_regular_file()) continue;
+            jobs.push_back({it->path(), outputRoot / std::filesystem::relative(it->path(), inputRoot), {}});
+        }
+        std::sort(jobs.begin(), jobs.end(), [](const Job& a, const Job& b) { return a.input < b.input; });
+        return jobs;
+    }
+    std::vector<BatchProcessor::Job> BatchProcessor::readManifest(const std::filesystem::path& manifest,
+                                                                  const std::filesystem::path& outputRoot)
+    {
+        std::ifstream in(manifest);
+        if (!in) throw std::runtime_error("Cannot open manifest: " + manifest.string());
+        std::filesystem::path base = manifest.parent_path();
+        std::vector<Job> jobs;
+        std::string line;
+        while (std::getline(in, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.empty() || line.front() == '#') continue;
+            size_t tab = line.find('\t');
+            std::filesystem::path source = line.substr(0, tab);
+            if (tab == std::string::npos) {
+                jobs.push_back({base / source, outputRoot / defaultOutput(source), {}});
+                continue;
+            }
+            std::filesystem::path relative = line.substr(tab + 1);
+            Job job{base / source, outputRoot / relative, {}};
+            if (!staysInside(relative)) job.error = "Output path escapes the output directory: " + relative.string();
+            jobs.push_back(std::move(job));
+        }
+        return jobs;
+    }
+    std::vector<BatchProcessor::Result> BatchProcessor::run(std::span<const Job> jobs, const ModeFactory& factory, bool encrypt) {
+        return run(jobs, factory, encrypt, Options{});
+    }
+    std::vector<BatchProcessor::Result> BatchProcessor::run(std::span<const Job> jobs, const ModeFactory& factory,
+                                                            bool encrypt, const Options& options)
+    {
+        if (options.chunkSize == 0) throw std::invalid_argument("Chunk size must be positive");
+        std::vector<Result> results(jobs.size());
+        std::vector<std::string> rejected(jobs.size());
+        std::map<std::filesystem::path, std::vector<size_t>> owners;
+        for (size_t i = 0; i < jobs.size(); ++i) {
+            rejected[i] = jobs[i].error;
+            owners[std::filesystem::absolute(jobs[i].output).lexically_normal()].push_back(i);
+        }
+        for (const auto& [output, indices] : owners) {
+            if (indices.size() < 2) continue;
+            for (size_t i : indices) {
+                if (rejected[i].empty()) rejected[i] = "Output path is shared by several jobs: " + output.string();
+            }
+        }
+        std::vector<uint64_t> sizes(jobs.size(), 0);
+        for (size_t i = 0; i < jobs.size(); ++i) {
+            std::error_code ec;
+            uint64_t size = std::filesystem::file_size(jobs[i].input, ec);
+            if (!ec) sizes[i] = size;
+        }
+        std::vector<size_t> order(jobs.size());
+        std::iota(order.begin(), order.end(), size_t{0});
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return sizes[a] > sizes[b]; });
+        MemoryBudget budget(options.memoryBudget);
+        tbb::parallel_for_each(order.begin(), order.end(), [&](size_t i) {
+            const Job& job = jobs[i];
+            Result& result = results[i];
+            result.input = job.input;
+            result.output = job.output;
+            result.bytesIn = sizes[i];
+            if (!rejected[i].empty()) {
+                result.error = rejected[i];
+                return;
+            }
+            auto start = std::chrono::steady_clock::now();
+            try {
+                FileProcessor::Options fileOptions;
+                size_t footprint;
+                if (sizes[i] >= options.largeFileThreshold) {
+                    fileOptions.backend = FileProcessor::Backend::MemoryMapped;
+                    fileOptions.chunkSize = options.chunkSize;
+                    footprint = 2 * options.chunkSize;
+                } else {
+                    fileOptions.backend = FileProcessor::Backend::Stream;
+                    fileOptions.chunkSize = static_cast<size_t>(std::clamp<uint64_t>(sizes[i], 1, options.chunkSize));
+                    footprint = 2 * fileOptions.chunkSize;
+                }
+                Lease lease(budget, footprint);
+                if (job.output.has_parent_path()) std::filesystem::create_directories(job.output.parent_path());
+                auto mode = factory();
+                if (!mode) throw std::runtime_error("Mode factory returned no mode");
+                tbb::this_task_arena::isolate([&] {
+                    FileProcessor::process(job.input, job.output, *mode, encrypt, fileOptions);
+                });
+                result.bytesOut = std::filesystem::file_size(job.output);
+                result.ok = true;
+            } catch (const std::exception& e) {
+                result.error = e.what();
+            }
+            result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        });
+        return results;
+    }
+    void BatchProcessor::writeReport(std::span<const Result> results, std::ostream& out) {
+        out << "status\tinput\toutput\tbytes_in\tbytes_out\tseconds\terror\n";
+        for (const auto& r : results) {
+            out << (r.ok ? "ok" : "failed") << '\t'
+                << r.input.string() << '\t'
+                << r.output.string() << '\t'
+                << r.bytesIn << '\t'
+                << r.bytesOut << '\t'
+                << r.seconds << '\t'
+                << r.error << '\n';
+        }
+    }
+}
\ No newline at end of file
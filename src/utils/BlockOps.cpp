@@ -0,0 +1,113 @@
+#include "crypto/utils/BlockOps.hpp"
+#include "crypto/utils/CpuFeatures.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+namespace crypto::utils {
+    using XorKernel = void (*)(Byte*, const Byte*, const Byte*, size_t);
+    static void xorScalar(Byte* dst, const Byte* a, const Byte* b, size_t n) {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            uint64_t x, y;
+            std::memcpy(&x, a + i, 8);
+            std::memcpy(&y, b + i, 8);
+            x ^= y;
+            std::memcpy(dst + i, &x, 8);
+        }
+        for (; i < n; ++i) dst[i] = a[i] ^ b[i];
+    }
+#if defined(__x86_64__) || defined(__i386__)
+    static void xorSSE2(Byte* dst, const Byte* a, const Byte* b, size_t n) {
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_xor_si128(x, y));
+        }
+        xorScalar(dst + i, a + i, b + i, n - i);
+    }
+    __attribute__((target("avx2"))) static void xorAVX2(Byte* dst, const Byte* a, const Byte* b, size_t n) {
+        size_t i = 0;
+        for (; i + 32 <= n; i += 32) {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_xor_si256(x, y));
+        }
+        xorSSE2(dst + i, a + i, b + i, n - i);
+    }
+    __attribute__((target("avx512f"))) static void xorAVX512(Byte* dst, const Byte* a, const Byte* b, size_t n) {
+        size_t i = 0;
+        for (; i + 64 <= n; i += 64) {
+            __m512i x = _mm512_loadu_si512(a + i);
+            __m512i y = _mm512_loadu_si512(b + i);
+            _mm512_storeu_si512(dst + i, _mm512_xor_si512(x, y));
+        }
+        xorAVX2(dst + i, a + i, b + i, n - i);
+    }
+    static void prefixXor16SSE2(Byte* data, size_t n) {
+        __m128i acc = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+        size_t i = 16;
+        for (; i + 16 <= n; i += 16) {
+            acc = _mm_xor_si128(acc, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i), acc);
+        }
+        for (; i < n; ++i) data[i] ^= data[i - 16];
+    }
+#endif
+    static void prefixXor8(Byte* data, size_t n) {
+        uint64_t acc;
+        std::memcpy(&acc, data, 8);
+        size_t i = 8;
+        for (; i + 8 <= n; i += 8) {
+            uint64_t x;
+            std::memcpy(&x, data + i, 8);
+            acc ^= x;
+            std::memcpy(data + i, &acc, 8);
+        }
+        for (; i < n; ++i) data[i] ^= data[i - 8];
+    }
+    static XorKernel selectKernel(size_t n) {
+        if (n < 32) return xorScalar;
+        switch (CpuFeatures::active()) {
+#if defined(__x86_64__) || defined(__i386__)
+            case SimdLevel::AVX512:
+            case SimdLevel::AVX512VBMI: return xorAVX512;
+            case SimdLevel::AVX2: return xorAVX2;
+            case SimdLevel::SSSE3: return xorSSE2;
+#endif
+            default: return xorScalar;
+        }
+    }
+    void BlockOps::xorInto(BytesSpan dst, ConstBytesSpan src) {
+        if (src.size() < dst.size()) throw std::invalid_argument("XOR source shorter than destination");
+        selectKernel(dst.size())(dst.data(), dst.data(), src.data(), dst.size());
+    }
+    void BlockOps::xor3(BytesSpan dst, ConstBytesSpan a, ConstBytesSpan b) {
+        if (a.size() < dst.size() || b.size() < dst.size()) throw std::invalid_argument("XOR source shorter than destination");
+        selectKernel(dst.size())(dst.data(), a.data(), b.data(), dst.size());
+    }
+    void BlockOps::prefixXor(BytesSpan data, size_t stride) {
+        if (stride == 0) throw std::invalid_argument("Prefix XOR stride must be positive");
+        if (data.size() <= stride) return;
+        if (stride < 8) {
+            for (size_t i = stride; i < data.size(); ++i) data[i] ^= data[i - stride];
+            return;
+        }
+        if (stride == 8) return prefixXor8(data.data(), data.size());
+#if defined(__x86_64__) || defined(__i386__)
+        if (stride == 16 && CpuFeatures::active() != SimdLevel::Scalar) return prefixXor16SSE2(data.data(), data.size());
+#endif
+        XorKernel kernel = selectKernel(stride);
+        for (size_t offset = stride; offset < data.size(); offset += stride) {
+            size_t len = std::min(stride, data.size() - offset);
+            kernel(data.data() + offset, data.data() + offset, data.data() + offset - stride, len);
+        }
+    }
+    void BlockOps::copy(BytesSpan dst, ConstBytesSpan src) {
+        if (dst.size() < src.size()) throw std::invalid_argument("Copy destination shorter than source");
+        if (!src.empty()) std::memmove(dst.data(), src.data(), src.size());
+    }
+}
\ No newline at end of file
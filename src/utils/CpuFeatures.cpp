@@ -0,0 +1,65 @@
+#include "crypto/utils/CpuFeatures.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+namespace crypto::utils {
+    static constexpr std::array<std::string_view, 5> LEVEL_NAMES = {"scalar", "ssse3", "avx2", "avx512", "avx512vbmi"};
+    static SimdLevel detectLevel() {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+            return __builtin_cpu_supports("avx512vbmi") ? SimdLevel::AVX512VBMI : SimdLevel::AVX512;
+        }
+        if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+        if (__builtin_cpu_supports("ssse3")) return SimdLevel::SSSE3;
+#endif
+        return SimdLevel::Scalar;
+    }
+    static SimdLevel clampToDetected(SimdLevel level) {
+        return std::min(level, CpuFeatures::detected());
+    }
+    static void reportUnknownLevel(std::string_view value) {
+        static std::once_flag reported;
+        std::call_once(reported, [&] {
+            std::cerr << "[WARNING] Ignoring unknown " << CpuFeatures::ENV_VARIABLE << " value '" << value << "'; accepted values:";
+            for (auto name : LEVEL_NAMES) std::cerr << ' ' << name;
+            std::cerr << "\n";
+        });
+    }
+    static SimdLevel initialLevel() {
+        if (const char* env = std::getenv(CpuFeatures::ENV_VARIABLE)) {
+            if (auto requested = CpuFeatures::parse(env)) return clampToDetected(*requested);
+            reportUnknownLevel(env);
+        }
+        return CpuFeatures::detected();
+    }
+    static std::atomic<SimdLevel>& activeLevel() {
+        static std::atomic<SimdLevel> level{initialLevel()};
+        return level;
+    }
+    SimdLevel CpuFeatures::detected() {
+        static const SimdLevel level = detectLevel();
+        return level;
+    }
+    SimdLevel CpuFeatures::active() {
+        return activeLevel().load(std::memory_order_relaxed);
+    }
+    void CpuFeatures::force(SimdLevel level) {
+        activeLevel().store(clampToDetected(level), std::memory_order_relaxed);
+    }
+    void CpuFeatures::reset() {
+        activeLevel().store(initialLevel(), std::memory_order_relaxed);
+    }
+    std::string_view CpuFeatures::toString(SimdLevel level) {
+        return LEVEL_NAMES[static_cast<size_t>(level)];
+    }
+    std::optional<SimdLevel> CpuFeatures::parse(std::string_view name) {
+        for (size_t i = 0; i < LEVEL_NAMES.size(); ++i) {
+            if (LEVEL_NAMES[i] == name) return static_cast<SimdLevel>(i);
+        }
+        return std::nullopt;
+    }
+}
\ No newline at end of file
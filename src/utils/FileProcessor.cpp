@@ -1,32 +1,261 @@
 #include "crypto/utils/FileProcessor.hpp"
-#include <fstream>
+#include "crypto/utils/MappedFile.hpp"
+#include "crypto/utils/AsyncIO.hpp"
+#include "crypto/utils/BlockOps.hpp"
+#include <tbb/parallel_pipeline.h>
+#include <cerrno>
+#include <cstdlib>
+#include <new>
 #include <vector>
 #include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
 namespace crypto::utils {
+    namespace {
+        class Descriptor {
+            int fd;
+        public:
+            Descriptor(const std::filesystem::path& path, int flags, bool direct) {
+                fd = ::open(path.c_str(), flags | O_CLOEXEC | (direct ? O_DIRECT : 0), 0644);
+                if (fd < 0 && direct && errno == EINVAL) fd = ::open(path.c_str(), flags | O_CLOEXEC, 0644);
+                if (fd < 0) throw std::runtime_error("Cannot open file: " + path.string());
+            }
+            Descriptor(const Descriptor&) = delete;
+            Descriptor& operator=(const Descriptor&) = delete;
+            ~Descriptor() { ::close(fd); }
+            int get() const { return fd; }
+        };
+        size_t alignUp(size_t value, size_t alignment) {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+    }
+    void FileProcessor::process(const std::filesystem::path& inPath,
+                                const std::filesystem::path& outPath,
+                                ICipherMode& mode,
+                                bool encrypt,
+                                Backend backend)
+    {
+        process(inPath, outPath, mode, encrypt, Options{backend});
+    }
     void FileProcessor::process(const std::filesystem::path& inPath,
                                 const std::filesystem::path& outPath,
                                 ICipherMode& mode,
-                                bool encrypt)
+                                bool encrypt,
+                                const Options& options)
     {
+        if (options.chunkSize == 0) throw std::invalid_argument("Chunk size must be positive");
+        if (options.inFlight == 0) throw std::invalid_argument("At least one buffer must be in flight");
         if (!std::filesystem::exists(inPath)) {
             throw std::runtime_error("Input file not found: " + inPath.string());
         }
-        std::ifstream inFile(inPath, std::ios::binary | std::ios::ate);
+        size_t tag = encrypt ? 0 : mode.tagSize();
+        uint64_t payload = std::filesystem::file_size(inPath);
+        if (payload < tag) throw std::runtime_error("Input is shorter than the authentication tag");
+        payload -= tag;
+        std::filesystem::path target = outPath;
+        if (tag > 0) target += ".part";
+        mode.begin(encrypt);
+        try {
+            switch (options.backend) {
+                case Backend::MemoryMapped: processMapped(inPath, target, mode, encrypt, payload, tag, options); break;
+                case Backend::Pipelined: processPipelined(inPath, target, mode, payload, tag, options); break;
+                case Backend::Async: processAsync(inPath, target, mode, payload, tag, options); break;
+                default: processStream(inPath, target, mode, payload, tag, options); break;
+            }
+            if (target != outPath) std::filesystem::rename(target, outPath);
+        } catch (...) {
+            if (target != outPath) std::filesystem::remove(target);
+            throw;
+        }
+    }
+    std::ifstream FileProcessor::openInput(const std::filesystem::path& inPath, ICipherMode& mode, uint64_t payload, size_t tag) {
+        std::ifstream inFile(inPath, std::ios::binary);
         if (!inFile) throw std::runtime_error("Cannot open input file");
-        std::streamsize size = inFile.tellg();
-        inFile.seekg(0, std::ios::beg);
-        Bytes buffer(size);
-        if (!inFile.read(reinterpret_cast<char*>(buffer.data()), size)) {
-            throw std::runtime_error("Error reading file");
-        }
-        Bytes result;
-        if (encrypt) {
-            result = mode.encrypt(buffer);
-        } else {
-            result = mode.decrypt(buffer);
+        if (tag > 0) {
+            Bytes expected(tag);
+            inFile.seekg(static_cast<std::streamoff>(payload));
+            if (!inFile.read(reinterpret_cast<char*>(expected.data()), static_cast<std::streamsize>(tag))) {
+                throw std::runtime_error("Error reading authentication tag");
+            }
+            inFile.seekg(0);
+            mode.setExpectedTag(expected);
+        }
+        return inFile;
+    }
+    void FileProcessor::processStream(const std::filesystem::path& inPath, const std::filesystem::path& outPath,
+                                      ICipherMode& mode, uint64_t payload, size_t tag, const Options& options)
+    {
+        std::ifstream inFile = openInput(inPath, mode, payload, tag);
+        std::ofstream outFile(outPath, std::ios::binary);
+        if (!outFile) throw std::runtime_error("Cannot open output file");
+        Bytes input(options.chunkSize);
+        Bytes output(options.chunkSize + 2 * mode.blockSize() + mode.tagSize());
+        auto write = [&](size_t size) {
+            if (!outFile.write(reinterpret_cast<const char*>(output.data()), static_cast<std::streamsize>(size))) {
+                throw std::runtime_error("Error writing file");
+            }
+        };
+        uint64_t remaining = payload;
+        while (remaining > 0) {
+            size_t want = static_cast<size_t>(std::min<uint64_t>(input.size(), remaining));
+            inFile.read(reinterpret_cast<char*>(input.data()), static_cast<std::streamsize>(want));
+            size_t got = static_cast<size_t>(inFile.gcount());
+            if (got == 0) break;
+            remaining -= got;
+            write(mode.update(std::span{input.data(), got}, output));
+        }
+        if (inFile.bad() || remaining > 0) throw std::runtime_error("Error reading file");
+        write(mode.finalize(output));
+        outFile.close();
+        if (!outFile) throw std::runtime_error("Error writing file");
+    }
+    void FileProcessor::processMapped(const std::filesystem::path& inPath, const std::filesystem::path& outPath,
+                                      ICipherMode& mode, bool encrypt, uint64_t payload, size_t tag, const Options& options)
+    {
+        MappedFile input = MappedFile::openRead(inPath);
+        if (input.size() != payload + tag) throw std::runtime_error("Input file changed while processing");
+        BytesSpan source = input.bytes();
+        if (tag > 0) mode.setExpectedTag(source.subspan(static_cast<size_t>(payload), tag));
+        uint64_t capacity = encrypt ? mode.encryptedSize(static_cast<size_t>(payload)) : payload;
+        MappedFile output = MappedFile::create(outPath, capacity);
+        BytesSpan target = output.bytes();
+        size_t produced = 0;
+        for (size_t offset = 0; offset < payload; offset += options.chunkSize) {
+            size_t len = static_cast<size_t>(std::min<uint64_t>(options.chunkSize, payload - offset));
+            produced += mode.update(source.subspan(offset, len), target.subspan(produced));
+            input.release(offset + len);
+            output.release(produced);
         }
+        produced += mode.finalize(target.subspan(produced));
+        output.close(produced);
+    }
+    void FileProcessor::processPipelined(const std::filesystem::path& inPath, const std::filesystem::path& outPath,
+                                         ICipherMode& mode, uint64_t payload, size_t tag, const Options& options)
+    {
+        struct Slot {
+            Bytes input, output;
+            size_t size = 0;
+        };
+        std::ifstream inFile = openInput(inPath, mode, payload, tag);
         std::ofstream outFile(outPath, std::ios::binary);
         if (!outFile) throw std::runtime_error("Cannot open output file");
-        outFile.write(reinterpret_cast<const char*>(result.data()), result.size());
+        size_t outputSize = options.chunkSize + 2 * mode.blockSize() + mode.tagSize();
+        std::vector<Slot> slots(options.inFlight);
+        auto write = [&](const Bytes& buffer, size_t size) {
+            if (!outFile.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(size))) {
+                throw std::runtime_error("Error writing file");
+            }
+        };
+        uint64_t remaining = payload;
+        size_t next = 0;
+        tbb::parallel_pipeline(options.inFlight,
+            tbb::make_filter<void, Slot*>(tbb::filter_mode::serial_in_order, [&](tbb::flow_control& control) -> Slot* {
+                if (remaining == 0) {
+                    control.stop();
+                    return nullptr;
+                }
+                Slot& slot = slots[next++ % slots.size()];
+                slot.input.resize(options.chunkSize);
+                size_t want = static_cast<size_t>(std::min<uint64_t>(options.chunkSize, remaining));
+                inFile.read(reinterpret_cast<char*>(slot.input.data()), static_cast<std::streamsize>(want));
+                if (static_cast<size_t>(inFile.gcount()) != want) throw std::runtime_error("Error reading file");
+                remaining -= want;
+                slot.size = want;
+                return &slot;
+            }) &
+            tbb::make_filter<Slot*, Slot*>(tbb::filter_mode::serial_in_order, [&](Slot* slot) {
+                slot->output.resize(outputSize);
+                slot->size = mode.update(std::span{slot->input.data(), slot->size}, slot->output);
+                return slot;
+            }) &
+            tbb::make_filter<Slot*, void>(tbb::filter_mode::serial_in_order, [&](Slot* slot) {
+                write(slot->output, slot->size);
+            }));
+        Bytes tail(outputSize);
+        write(tail, mode.finalize(tail));
+        outFile.close();
+        if (!outFile) throw std::runtime_error("Error writing file");
+    }
+    void FileProcessor::processAsync(const std::filesystem::path& inPath, const std::filesystem::path& outPath,
+                                     ICipherMode& mode, uint64_t payload, size_t tag, const Options& options)
+    {
+        constexpr size_t ALIGNMENT = AsyncIO::DIRECT_ALIGNMENT;
+        if (tag > 0) openInput(inPath, mode, payload, tag);
+        size_t depth = options.inFlight;
+        size_t chunk = alignUp(options.chunkSize, ALIGNMENT);
+        size_t outputSize = alignUp(chunk + ALIGNMENT + 2 * mode.blockSize() + mode.tagSize(), ALIGNMENT);
+        std::unique_ptr<Byte, decltype(&std::free)> arena(
+            static_cast<Byte*>(std::aligned_alloc(ALIGNMENT, depth * (chunk + outputSize))), &std::free);
+        if (!arena) throw std::bad_alloc();
+        std::vector<BytesSpan> buffers;
+        for (size_t i = 0; i < depth; ++i) buffers.emplace_back(arena.get() + i * chunk, chunk);
+        for (size_t i = 0; i < depth; ++i) buffers.emplace_back(arena.get() + depth * chunk + i * outputSize, outputSize);
+        Descriptor input(inPath, O_RDONLY, options.direct);
+        Descriptor output(outPath, O_WRONLY | O_CREAT | O_TRUNC, options.direct);
+        auto io = AsyncIO::create(buffers, buffers.size());
+        std::vector<int64_t> readLength(depth, -1);
+        std::vector<size_t> writeLength(depth, 0);
+        std::vector<size_t> freeWrites;
+        for (size_t i = depth + 1; i < 2 * depth; ++i) freeWrites.push_back(i);
+        size_t writesInFlight = 0;
+        auto complete = [&] {
+            AsyncIO::Completion done = io->wait();
+            if (done.slot < depth) {
+                if (done.result < 0) throw std::runtime_error("Error reading file");
+                readLength[done.slot] = done.result;
+                return;
+            }
+            --writesInFlight;
+            if (done.result != static_cast<int64_t>(writeLength[done.slot - depth])) throw std::runtime_error("Error writing file");
+            freeWrites.push_back(done.slot);
+        };
+        size_t current = depth;
+        size_t carry = 0;
+        uint64_t written = 0;
+        bool padded = false;
+        auto flush = [&](size_t fill, bool last) {
+            size_t length = fill / ALIGNMENT * ALIGNMENT;
+            if (last) length = options.direct ? alignUp(fill, ALIGNMENT) : fill;
+            if (length > 0) {
+                writeLength[current - depth] = length;
+                io->submitWrite(output.get(), current, length, written);
+                ++writesInFlight;
+            }
+            if (last) {
+                written += fill;
+                padded = length != fill;
+                return;
+            }
+            if (length == 0) {
+                carry = fill;
+                return;
+            }
+            while (freeWrites.empty()) complete();
+            size_t next = freeWrites.back();
+            freeWrites.pop_back();
+            carry = fill - length;
+            BlockOps::copy(buffers[next].first(carry), buffers[current].subspan(length, carry));
+            written += length;
+            current = next;
+        };
+        uint64_t chunks = (payload + chunk - 1) / chunk;
+        for (uint64_t index = 0; index < std::min<uint64_t>(depth, chunks); ++index) {
+            io->submitRead(input.get(), static_cast<size_t>(index), chunk, index * chunk);
+        }
+        for (uint64_t index = 0; index < chunks; ++index) {
+            auto slot = static_cast<size_t>(index % depth);
+            while (readLength[slot] < 0) complete();
+            auto length = static_cast<size_t>(std::min<uint64_t>(chunk, payload - index * chunk));
+            if (static_cast<size_t>(readLength[slot]) < length) throw std::runtime_error("Error reading file");
+            readLength[slot] = -1;
+            size_t fill = carry + mode.update(buffers[slot].first(length), buffers[current].subspan(carry));
+            if (index + depth < chunks) io->submitRead(input.get(), slot, chunk, (index + depth) * chunk);
+            flush(fill, false);
+        }
+        flush(carry + mode.finalize(buffers[current].subspan(carry)), true);
+        while (writesInFlight > 0) complete();
+        if (padded && ::ftruncate(output.get(), static_cast<off_t>(written)) != 0) {
+            throw std::runtime_error("Error writing file");
+        }
     }
 }
\ No newline at end of file
@@ -0,0 +1,72 @@
+#include "crypto/utils/KeystreamRing.hpp"
+#include "crypto/utils/BlockOps.hpp"
+#include <algorithm>
+#include <stdexcept>
+namespace crypto::utils {
+    KeystreamRing::KeystreamRing(size_t segmentSize, size_t segmentCount, Producer producer)
+        : segments(segmentCount, Bytes(segmentSize)), ready(segmentCount, false), producer(std::move(producer))
+    {
+        if (segmentSize == 0 || segmentCount == 0) throw std::invalid_argument("Keystream ring needs non-empty segments");
+        worker = std::thread([this] { produce(); });
+    }
+    KeystreamRing::~KeystreamRing() {
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+        changed.notify_all();
+        worker.join();
+    }
+    void KeystreamRing::produce() {
+        while (true) {
+            size_t slot;
+            {
+                std::unique_lock lock(mutex);
+                changed.wait(lock, [&] { return stopping || !ready[writeIndex]; });
+                if (stopping) return;
+                slot = writeIndex;
+            }
+            try {
+                producer(segments[slot]);
+            } catch (...) {
+                {
+                    std::lock_guard lock(mutex);
+                    failure = std::current_exception();
+                }
+                changed.notify_all();
+                return;
+            }
+            {
+                std::lock_guard lock(mutex);
+                ready[slot] = true;
+                writeIndex = (writeIndex + 1) % segments.size();
+            }
+            changed.notify_all();
+        }
+    }
+    void KeystreamRing::apply(ConstBytesSpan input, BytesSpan output) {
+        size_t done = 0;
+        while (done < input.size()) {
+            {
+                std::unique_lock lock(mutex);
+                changed.wait(lock, [&] { return ready[readIndex] || failure; });
+                if (!ready[readIndex]) std::rethrow_exception(failure);
+            }
+            const Bytes& segment = segments[readIndex];
+            size_t len = std::min(segment.size() - readOffset, input.size() - done);
+            BytesSpan out = output.subspan(done, len);
+            BlockOps::xor3(out, input.subspan(done, len), std::span{segment.data() + readOffset, len});
+            done += len;
+            readOffset += len;
+            if (readOffset == segment.size()) {
+                readOffset = 0;
+                {
+                    std::lock_guard lock(mutex);
+                    ready[readIndex] = false;
+                    readIndex = (readIndex + 1) % segments.size();
+                }
+                changed.notify_all();
+            }
+        }
+    }
+}
\ No newline at end of file
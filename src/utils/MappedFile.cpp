@@ -0,0 +1,81 @@
+#include "crypto/utils/MappedFile.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+namespace crypto::utils {
+    static uint64_t pageSize() {
+        static const uint64_t size = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+        return size;
+    }
+    MappedFile::MappedFile(int fd_, uint64_t length_, bool writable) : fd(fd_), length(length_) {
+        if (length == 0) return;
+        int protection = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+        void* address = mmap(nullptr, static_cast<size_t>(length), protection, MAP_SHARED, fd, 0);
+        if (address == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Cannot map file");
+        }
+        base = static_cast<Byte*>(address);
+        madvise(address, static_cast<size_t>(length), MADV_SEQUENTIAL);
+    }
+    MappedFile MappedFile::openRead(const std::filesystem::path& path) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) throw std::runtime_error("Cannot open input file: " + path.string());
+        struct stat info {};
+        if (fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Cannot stat input file: " + path.string());
+        }
+        return MappedFile(fd, static_cast<uint64_t>(info.st_size), false);
+    }
+    MappedFile MappedFile::create(const std::filesystem::path& path, uint64_t size) {
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) throw std::runtime_error("Cannot open output file: " + path.string());
+        if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Cannot size output file: " + path.string());
+        }
+        return MappedFile(fd, size, true);
+    }
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+        : fd(std::exchange(other.fd, -1)), base(std::exchange(other.base, nullptr)),
+          length(std::exchange(other.length, 0)), released(std::exchange(other.released, 0)) {}
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            if (fd >= 0) ::close(fd);
+            fd = std::exchange(other.fd, -1);
+            base = std::exchange(other.base, nullptr);
+            length = std::exchange(other.length, 0);
+            released = std::exchange(other.released, 0);
+        }
+        return *this;
+    }
+    MappedFile::~MappedFile() {
+        unmap();
+        if (fd >= 0) ::close(fd);
+    }
+    void MappedFile::unmap() {
+        if (base) munmap(base, static_cast<size_t>(length));
+        base = nullptr;
+    }
+    void MappedFile::release(uint64_t end) {
+        uint64_t aligned = std::min(end, length) / pageSize() * pageSize();
+        if (!base || aligned <= released) return;
+        madvise(base + released, static_cast<size_t>(aligned - released), MADV_DONTNEED);
+        released = aligned;
+    }
+    void MappedFile::close(uint64_t finalSize) {
+        unmap();
+        if (fd < 0) return;
+        bool resized = finalSize == length || ftruncate(fd, static_cast<off_t>(finalSize)) == 0;
+        int status = ::close(std::exchange(fd, -1));
+        length = 0;
+        if (!resized || status != 0) throw std::runtime_error("Error writing file");
+    }
+}
\ No newline at end of file
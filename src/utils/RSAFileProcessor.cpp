@@ -1,7 +1,6 @@
 #include "crypto/utils/RSAFileProcessor.hpp"
 #include <fstream>
 #include <vector>
-#include <execution>
 #include <algorithm>
 namespace crypto::utils {
     Bytes readFile(const std::filesystem::path& path) {
@@ -19,41 +18,30 @@ namespace crypto::utils {
         if (!file) throw std::runtime_error("Cannot open file: " + path.string());
         file.write(reinterpret_cast<const char*>(data.data()), data.size());
     }
-    void RSAFileProcessor::encryptFile(const std::filesystem::path& inPath, const std::filesystem::path& outPath, const PublicKey& pubKey, size_t keySizeBits) {
+    void RSAFileProcessor::encryptFile(const std::filesystem::path& inPath, const std::filesystem::path& outPath, const PublicKey& pubKey, size_t keySizeBits, const ScheduleOptions& schedule) {
         size_t keySizeBytes = keySizeBits / 8;
         size_t maxDataSize = keySizeBytes - 11;
         Bytes input = readFile(inPath);
         size_t blockCount = (input.size() + maxDataSize - 1) / maxDataSize;
-        std::vector<Bytes> outputBlocks(blockCount);
-        std::vector<size_t> indices(blockCount);
-        std::iota(indices.begin(), indices.end(), 0);
+        Bytes output(blockCount * keySizeBytes, Byte{0});
         asymmetric::RSA rsa;
-        std::for_each(std::execution::par, indices.begin(), indices.end(), [&](size_t i) {
-            size_t offset = i * maxDataSize;
-            size_t len = std::min(maxDataSize, input.size() - offset);
-            Bytes chunk(input.begin() + offset, input.begin() + offset + len);
-            BigInt padded = padding::RSA_PKCS1::pad(chunk, keySizeBytes);
-            BigInt encrypted = rsa.encrypt(padded, pubKey);
-            using boost::multiprecision::export_bits;
-            std::vector<uint8_t> tempBuffer;
-            export_bits(encrypted, std::back_inserter(tempBuffer), 8);
-            Bytes outChunk;
-            outChunk.reserve(tempBuffer.size());
-            for(auto val : tempBuffer) outChunk.push_back(static_cast<Byte>(val));
-            if (outChunk.size() < keySizeBytes) {
-                Bytes aligned(keySizeBytes - outChunk.size(), Byte{0});
-                aligned.insert(aligned.end(), outChunk.begin(), outChunk.end());
-                outputBlocks[i] = aligned;
-            } else {
-                outputBlocks[i] = outChunk;
+        Scheduler::forEachChunk(blockCount, schedule, [&](size_t, size_t first, size_t count) {
+            for (size_t i = first; i < first + count; ++i) {
+                size_t offset = i * maxDataSize;
+                size_t len = std::min(maxDataSize, input.size() - offset);
+                Bytes chunk(input.begin() + offset, input.begin() + offset + len);
+                BigInt padded = padding::RSA_PKCS1::pad(chunk, keySizeBytes);
+                BigInt encrypted = rsa.encrypt(padded, pubKey);
+                using boost::multiprecision::export_bits;
+                std::vector<uint8_t> tempBuffer;
+                export_bits(encrypted, std::back_inserter(tempBuffer), 8);
+                auto slot = output.begin() + (i + 1) * keySizeBytes - tempBuffer.size();
+                for (auto val : tempBuffer) *slot++ = static_cast<Byte>(val);
             }
         });
-        std::ofstream outFile(outPath, std::ios::binary);
-        for (const auto& block : outputBlocks) {
-            outFile.write(reinterpret_cast<const char*>(block.data()), block.size());
-        }
+        writeFile(outPath, output);
     }
-    void RSAFileProcessor::decryptFile(const std::filesystem::path& inPath, const std::filesystem::path& outPath, const PrivateKey& privKey, size_t keySizeBits) {
+    void RSAFileProcessor::decryptFile(const std::filesystem::path& inPath, const std::filesystem::path& outPath, const PrivateKey& privKey, size_t keySizeBits, const ScheduleOptions& schedule) {
         size_t keySizeBytes = keySizeBits / 8;
         Bytes input = readFile(inPath);
         if (input.size() % keySizeBytes != 0) {
@@ -61,20 +49,19 @@ namespace crypto::utils {
         }
         size_t blockCount = input.size() / keySizeBytes;
         std::vector<Bytes> outputBlocks(blockCount);
-        std::vector<size_t> indices(blockCount);
-        std::iota(indices.begin(), indices.end(), 0);
         asymmetric::RSA rsa;
-        std::for_each(std::execution::par, indices.begin(), indices.end(), [&](size_t i) {
-            size_t offset = i * keySizeBytes;
-            Bytes chunk(input.begin() + offset, input.begin() + offset + keySizeBytes);
-            std::vector<uint8_t> tempChunk;
-            tempChunk.reserve(chunk.size());
-            for(auto b : chunk) tempChunk.push_back(static_cast<uint8_t>(b));
-            using boost::multiprecision::import_bits;
-            BigInt encrypted;
-            import_bits(encrypted, tempChunk.begin(), tempChunk.end(), 8);
-            BigInt decrypted = rsa.decrypt(encrypted, privKey);
-            outputBlocks[i] = padding::RSA_PKCS1::unpad(decrypted, keySizeBytes);
+        Scheduler::forEachChunk(blockCount, schedule, [&](size_t, size_t first, size_t count) {
+            for (size_t i = first; i < first + count; ++i) {
+                size_t offset = i * keySizeBytes;
+                std::vector<uint8_t> tempChunk;
+                tempChunk.reserve(keySizeBytes);
+                for (size_t j = 0; j < keySizeBytes; ++j) tempChunk.push_back(static_cast<uint8_t>(input[offset + j]));
+                using boost::multiprecision::import_bits;
+                BigInt encrypted;
+                import_bits(encrypted, tempChunk.begin(), tempChunk.end(), 8);
+                BigInt decrypted = rsa.decrypt(encrypted, privKey);
+                outputBlocks[i] = padding::RSA_PKCS1::unpad(decrypted, keySizeBytes);
+            }
         });
         std::ofstream outFile(outPath, std::ios::binary);
         for (const auto& block : outputBlocks) {
@@ -4,17 +4,32 @@
 #include <memory>
 #include <random>
 #include <algorithm>
+#include <functional>
 #include "crypto/symmetric/DES.hpp"
 #include "crypto/symmetric/TripleDES.hpp"
 #include "crypto/symmetric/DEAL.hpp"
+#include "crypto/symmetric/BitslicedDES.hpp"
+#include "crypto/symmetric/SharedCipher.hpp"
 #include "crypto/modes/ECB.hpp"
 #include "crypto/modes/CBC.hpp"
 #include "crypto/modes/CTR.hpp"
+#include "crypto/modes/CFB.hpp"
+#include "crypto/modes/PCBC.hpp"
+#include "crypto/modes/Mode.hpp"
+#include "crypto/modes/AuthenticatedCBC.hpp"
 #include "crypto/modes/RandomDelta.hpp"
+#include "crypto/modes/MultiBufferCBC.hpp"
 #include "crypto/padding/PKCS7.hpp"
 #include "crypto/padding/ANSIX923.hpp"
 #include "crypto/padding/ISO10126.hpp"
 #include "crypto/padding/Zeros.hpp"
+#include "crypto/utils/CpuFeatures.hpp"
+#include "crypto/utils/BlockOps.hpp"
+#include "crypto/utils/FileProcessor.hpp"
+#include "crypto/utils/BatchProcessor.hpp"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
 using namespace crypto;
 struct CryptoParams {
     std::string algoName;
@@ -59,6 +74,9 @@ protected:
         } else if (p.modeName == "RD") {
             Bytes seedIv(4, Byte{0});
             return std::make_unique<modes::RandomDelta>(std::move(cipher), std::move(padding), seedIv);
+        } else if (p.modeName == "RDP") {
+            Bytes seedIv(8, Byte{0x3C});
+            return std::make_unique<modes::RandomDelta>(std::move(cipher), std::move(padding), seedIv, modes::DeltaGenerator::Philox);
         }
         throw std::runtime_error("Unknown mode");
     }
@@ -84,12 +102,64 @@ TEST_P(CryptoRoundTripTest, EncryptDecryptMatchesOriginal) {
     }) << "Decryption failed for " << params;
     ASSERT_EQ(original, decrypted) << "Decrypted data mismatch for " << params;
 }
+TEST_P(CryptoRoundTripTest, InPlaceMatchesAllocating) {
+    CryptoParams params = GetParam();
+    size_t dataSize = 8 * 2500 + 5;
+    Bytes original = generateRandomBytes(dataSize);
+    original.back() = Byte{0x5A};
+    Bytes key = generateRandomBytes(params.keySize);
+    Bytes encrypted = createStack(params, key)->encrypt(original);
+    auto mode = createStack(params, key);
+    Bytes buffer(mode->encryptedSize(dataSize));
+    std::copy(original.begin(), original.end(), buffer.begin());
+    size_t length = mode->encryptInPlace(buffer, dataSize);
+    ASSERT_EQ(length, encrypted.size());
+    if (params.paddingName != "ISO") {
+        EXPECT_EQ(buffer, encrypted) << "In-place ciphertext mismatch for " << params;
+    }
+    buffer.resize(length);
+    length = mode->decryptInPlace(buffer);
+    buffer.resize(length);
+    EXPECT_EQ(buffer, original) << "In-place round trip mismatch for " << params;
+}
+TEST_P(CryptoRoundTripTest, StreamingMatchesOneShot) {
+    CryptoParams params = GetParam();
+    size_t dataSize = 8 * 1500 + 3;
+    Bytes original = generateRandomBytes(dataSize);
+    original.back() = Byte{0x5A};
+    Bytes key = generateRandomBytes(params.keySize);
+    auto mode = createStack(params, key);
+    Bytes oneShot = mode->encrypt(original);
+    const std::vector<size_t> chunkSizes = {1, 7, 13, 64, 333, 5000};
+    auto stream = [&](ConstBytesSpan input, bool encrypt) {
+        Bytes result(input.size() + mode->blockSize());
+        Bytes output(5000 + mode->blockSize());
+        size_t produced = 0;
+        mode->begin(encrypt);
+        for (size_t offset = 0, i = 0; offset < input.size(); ++i) {
+            size_t len = std::min(chunkSizes[i % chunkSizes.size()], input.size() - offset);
+            size_t n = mode->update(input.subspan(offset, len), output);
+            std::copy_n(output.begin(), n, result.begin() + produced);
+            produced += n;
+            offset += len;
+        }
+        size_t n = mode->finalize(output);
+        std::copy_n(output.begin(), n, result.begin() + produced);
+        result.resize(produced + n);
+        return result;
+    };
+    Bytes streamed = stream(original, true);
+    if (params.paddingName != "ISO") {
+        EXPECT_EQ(streamed, oneShot) << "Streaming ciphertext mismatch for " << params;
+    }
+    EXPECT_EQ(stream(streamed, false), original) << "Streaming round trip mismatch for " << params;
+}
 const std::vector<std::pair<std::string, size_t>> ALGOS = {
     {"DES", 8},
     {"3DES", 24},
     {"DEAL", 16}
 };
-const std::vector<std::string> BLOCK_MODES = {"ECB", "CBC", "RD"};
+const std::vector<std::string> BLOCK_MODES = {"ECB", "CBC", "RD", "RDP"};
 const std::vector<std::string> PADDINGS = {"PKCS7", "ANSI", "ISO", "Zeros"};
 const std::vector<std::string> STREAM_MODES = {"CTR"};
 std::vector<CryptoParams> GenerateParams() {
@@ -114,6 +184,496 @@ INSTANTIATE_TEST_SUITE_P(
         return info.param.algoName + "_" + info.param.modeName + "_" + info.param.paddingName;
     }
 );
+Bytes fromHex(const std::string& hex) {
+    Bytes res;
+    for (size_t i = 0; i + 1 < hex.size(); i += 2) {
+        res.push_back(static_cast<Byte>(std::stoi(hex.substr(i, 2), nullptr, 16)));
+    }
+    return res;
+}
+TEST(DES_Core, KnownAnswerVectors) {
+    struct Vector { std::string key, plain, cipher; };
+    const std::vector<Vector> vectors = {
+        {"133457799BBCDFF1", "0123456789ABCDEF", "85E813540F0AB405"},
+        {"0E329232EA6D0D73", "8787878787878787", "0000000000000000"},
+    };
+    for (const auto& v : vectors) {
+        symmetric::DES des(fromHex(v.key));
+        Bytes plain = fromHex(v.plain);
+        Bytes enc(8), dec(8);
+        des.encryptBlock(plain, enc);
+        EXPECT_EQ(enc, fromHex(v.cipher)) << v.key;
+        des.decryptBlock(enc, dec);
+        EXPECT_EQ(dec, plain) << v.key;
+    }
+}
+TEST(TripleDES_Core, KnownAnswerVector) {
+    symmetric::TripleDES tdes(fromHex("0123456789ABCDEF23456789ABCDEF01456789ABCDEF0123"));
+    Bytes plain = fromHex("5468652071756663");
+    Bytes enc(8), dec(8);
+    tdes.encryptBlock(plain, enc);
+    EXPECT_EQ(enc, fromHex("A826FD8CE53B855F"));
+    tdes.decryptBlock(enc, dec);
+    EXPECT_EQ(dec, plain);
+}
+TEST(DES_Batch, BitslicedMatchesScalar) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<> dis(0, 255);
+    auto randomBytes = [&](size_t n) {
+        Bytes res(n);
+        for (auto& b : res) b = static_cast<Byte>(dis(gen));
+        return res;
+    };
+    std::vector<std::unique_ptr<IBlockCipher>> ciphers;
+    ciphers.push_back(std::make_unique<symmetric::DES>(randomBytes(8)));
+    ciphers.push_back(std::make_unique<symmetric::TripleDES>(randomBytes(24)));
+    size_t nBlocks = 2 * symmetric::BitslicedDES::lanes() + 37;
+    Bytes plain = randomBytes(nBlocks * 8);
+    for (auto& cipher : ciphers) {
+        Bytes expected(plain.size());
+        for (size_t i = 0; i < nBlocks; ++i) {
+            cipher->encryptBlock(std::span{plain.data() + i * 8, 8}, std::span{expected.data() + i * 8, 8});
+        }
+        Bytes batch(plain.size());
+        cipher->encryptBlocks(plain, batch, nBlocks);
+        EXPECT_EQ(batch, expected);
+        cipher->decryptBlocks(batch, batch, nBlocks);
+        EXPECT_EQ(batch, plain);
+        EXPECT_THROW(cipher->encryptBlocks(std::span{plain}.first(plain.size() - 8), batch, nBlocks), std::invalid_argument);
+        EXPECT_THROW(cipher->decryptBlocks(plain, std::span{batch}.first(batch.size() - 1), nBlocks), std::invalid_argument);
+    }
+}
+TEST(DES_Batch, EveryDispatchLevelMatchesScalar) {
+    std::mt19937 gen(11);
+    std::uniform_int_distribution<> dis(0, 255);
+    Bytes key(24), plain(8 * 1000);
+    for (auto& b : key) b = static_cast<Byte>(dis(gen));
+    for (auto& b : plain) b = static_cast<Byte>(dis(gen));
+    symmetric::TripleDES cipher(key);
+    Bytes expected(plain.size());
+    for (size_t i = 0; i < 1000; ++i) {
+        cipher.encryptBlock(std::span{plain.data() + i * 8, 8}, std::span{expected.data() + i * 8, 8});
+    }
+    for (int level = 0; level <= static_cast<int>(utils::CpuFeatures::detected()); ++level) {
+        utils::CpuFeatures::force(static_cast<utils::SimdLevel>(level));
+        Bytes batch(plain.size());
+        cipher.encryptBlocks(plain, batch, 1000);
+        EXPECT_EQ(batch, expected) << utils::CpuFeatures::toString(utils::CpuFeatures::active());
+        cipher.decryptBlocks(batch, batch, 1000);
+        EXPECT_EQ(batch, plain);
+    }
+    utils::CpuFeatures::reset();
+}
+TEST(DEAL_Batch, BatchMatchesScalar) {
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<> dis(0, 255);
+    Bytes key(16), plain(16 * 300);
+    for (auto& b : key) b = static_cast<Byte>(dis(gen));
+    for (auto& b : plain) b = static_cast<Byte>(dis(gen));
+    symmetric::DEAL deal(key);
+    size_t nBlocks = plain.size() / 16;
+    Bytes expected(plain.size());
+    for (size_t i = 0; i < nBlocks; ++i) {
+        deal.encryptBlock(std::span{plain.data() + i * 16, 16}, std::span{expected.data() + i * 16, 16});
+    }
+    Bytes batch(plain.size());
+    deal.encryptBlocks(plain, batch, nBlocks);
+    EXPECT_EQ(batch, expected);
+    deal.decryptBlocks(batch, batch, nBlocks);
+    EXPECT_EQ(batch, plain);
+}
+TEST(PKCS7Padding, EmptyCiphertextIsRejected) {
+    Bytes key(8, Byte{0x4C}), iv(8, Byte{0x19});
+    modes::CBC cbc(std::make_unique<symmetric::DES>(key), std::make_unique<padding::PKCS7>(), iv);
+    EXPECT_EQ(cbc.encrypt(Bytes{}).size(), 8u);
+    EXPECT_THROW(cbc.decrypt(Bytes{}), std::runtime_error);
+    modes::CBC zeros(std::make_unique<symmetric::DES>(key), std::make_unique<padding::Zeros>(), iv);
+    EXPECT_TRUE(zeros.decrypt(zeros.encrypt(Bytes{})).empty());
+}
+TEST(ZerosPadding, StripsOnlyTheFinalBlock) {
+    Bytes key(8, Byte{0x4C}), iv(8, Byte{0x19});
+    Bytes original = {Byte{'A'}, Byte{'B'}, Byte{'C'}};
+    original.resize(3 + 20, Byte{0});
+    modes::CBC cbc(std::make_unique<symmetric::DES>(key), std::make_unique<padding::Zeros>(), iv);
+    Bytes encrypted = cbc.encrypt(original);
+    ASSERT_EQ(encrypted.size(), 24u);
+    Bytes decrypted = cbc.decrypt(encrypted);
+    EXPECT_EQ(decrypted, Bytes(original.begin(), original.begin() + 16));
+}
+TEST(MultiBufferCBC, MatchesPerStreamCBC) {
+    std::mt19937 gen(23);
+    std::uniform_int_distribution<> dis(0, 255);
+    auto randomBytes = [&](size_t n) {
+        Bytes res(n);
+        for (auto& b : res) b = static_cast<Byte>(dis(gen));
+        return res;
+    };
+    std::vector<std::unique_ptr<IBlockCipher>> ciphers;
+    for (size_t i = 0; i < 150; ++i) ciphers.push_back(std::make_unique<symmetric::DES>(randomBytes(8)));
+    for (size_t i = 0; i < 70; ++i) ciphers.push_back(std::make_unique<symmetric::TripleDES>(randomBytes(24)));
+    for (size_t i = 0; i < 70; ++i) ciphers.push_back(std::make_unique<symmetric::DEAL>(randomBytes(16)));
+    std::vector<Bytes> ivs, inputs, outputs;
+    for (size_t i = 0; i < ciphers.size(); ++i) {
+        size_t bs = ciphers[i]->getBlockSize();
+        ivs.push_back(randomBytes(bs));
+        inputs.push_back(randomBytes((i * 37) % 300));
+        outputs.emplace_back(inputs.back().size() + bs);
+    }
+    std::vector<modes::MultiBufferCBC::Stream> streams;
+    for (size_t i = 0; i < ciphers.size(); ++i) {
+        streams.push_back({ciphers[i].get(), ivs[i], inputs[i], outputs[i]});
+    }
+    modes::MultiBufferCBC engine(std::make_unique<padding::PKCS7>());
+    std::vector<size_t> sizes = engine.encrypt(streams);
+    for (size_t i = 0; i < ciphers.size(); ++i) {
+        modes::CBC cbc(std::move(ciphers[i]), std::make_unique<padding::PKCS7>(), ivs[i]);
+        Bytes expected = cbc.encrypt(inputs[i]);
+        ASSERT_EQ(sizes[i], expected.size());
+        EXPECT_TRUE(std::equal(expected.begin(), expected.end(), outputs[i].begin())) << "stream " << i;
+    }
+}
+TEST(Scheduler, ChunkingDoesNotChangeOutput) {
+    Bytes key(8, Byte{0x31}), iv(8, Byte{0x07}), data(8 * 999 + 3);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<Byte>(i * 29);
+    std::vector<std::function<std::unique_ptr<ICipherMode>()>> factories = {
+        [&] { return std::make_unique<modes::ECB>(std::make_unique<symmetric::DES>(key), std::make_unique<padding::PKCS7>()); },
+        [&] { return std::make_unique<modes::CBC>(std::make_unique<symmetric::DES>(key), std::make_unique<padding::PKCS7>(), iv); },
+        [&] { return std::make_unique<modes::CTR>(std::make_unique<symmetric::DES>(key), iv); },
+        [&] { return std::make_unique<modes::CFB>(std::make_unique<symmetric::DES>(key), std::make_unique<padding::PKCS7>(), iv); },
+        [&] { return std::make_unique<modes::CFB>(std::make_unique<symmetric::DES>(key), nullptr, iv, 1); },
+        [&] { return std::make_unique<modes::PCBC>(std::make_unique<symmetric::DES>(key), std::make_unique<padding::PKCS7>(), iv); },
+        [&] { return std::make_unique<modes::RandomDelta>(std::make_unique<symmetric::DES>(key), std::make_unique<padding::PKCS7>(), iv, modes::DeltaGenerator::Philox); }
+    };
+    for (auto& factory : factories) {
+        Bytes expected = factory()->encrypt(data);
+        for (utils::ScheduleOptions options : {utils::ScheduleOptions{1, 0}, utils::ScheduleOptions{7, 0}, utils::ScheduleOptions{64, 100000}}) {
+            auto mode = factory();
+            mode->setSchedule(options);
+            Bytes encrypted = mode->encrypt(data);
+            EXPECT_EQ(encrypted, expected) << options.grainBlocks;
+            mode->decryptInPlace(encrypted);
+            EXPECT_TRUE(std::equal(data.begin(), data.end(), encrypted.begin())) << options.grainBlocks;
+        }
+    }
+    EXPECT_THROW(factories[0]()->setSchedule({0, 0}), std::invalid_argument);
+}
+TEST(RandomDelta, PhiloxKnownAnswers) {
+    using Philox = utils::Philox4x32;
+    EXPECT_EQ(Philox::generate({0, 0, 0, 0}, {0, 0}), (Philox::Counter{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}));
+    EXPECT_EQ(Philox::generate({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff}),
+              (Philox::Counter{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}));
+    EXPECT_EQ(Philox::generate({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0}),
+              (Philox::Counter{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}));
+}
+TEST(RandomDelta, PhiloxSeekMatchesSequential) {
+    Bytes key(24, Byte{0x5D}), iv(8, Byte{0xA1}), data(8 * 600);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<Byte>(i * 13 + 7);
+    auto make = [&] { return modes::RandomDelta(std::make_unique<symmetric::TripleDES>(key), nullptr, iv, modes::DeltaGenerator::Philox); };
+    auto mode = make();
+    Bytes encrypted = mode.encrypt(data);
+    size_t offset = 8 * 250;
+    Bytes tail(data.size() - offset);
+    mode.seek(offset, true);
+    mode.update(std::span{data.data() + offset, tail.size()}, tail);
+    EXPECT_TRUE(std::equal(tail.begin(), tail.end(), encrypted.begin() + offset));
+    mode.seek(offset, false);
+    mode.update(std::span{encrypted.data() + offset, tail.size()}, tail);
+    EXPECT_TRUE(std::equal(tail.begin(), tail.end(), data.begin() + offset));
+    EXPECT_THROW(mode.seek(3, true), std::invalid_argument);
+    modes::RandomDelta legacy(std::make_unique<symmetric::TripleDES>(key), nullptr, iv);
+    EXPECT_THROW(legacy.seek(0, true), std::invalid_argument);
+    EXPECT_NE(legacy.encrypt(data), encrypted);
+}
+TEST(ComposedMode, MatchesVirtualPath) {
+    Bytes key3(24), key2(16), iv8(8, Byte{0x42}), iv16(16, Byte{0x24}), data(8 * 777 + 3);
+    for (size_t i = 0; i < key3.size(); ++i) key3[i] = static_cast<Byte>(i * 7 + 1);
+    for (size_t i = 0; i < key2.size(); ++i) key2[i] = static_cast<Byte>(i * 5 + 3);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<Byte>(i * 31);
+    std::vector<std::pair<std::unique_ptr<ICipherMode>, std::unique_ptr<ICipherMode>>> pairs;
+    pairs.emplace_back(std::make_unique<modes::Mode<modes::CBC, symmetric::TripleDES, padding::PKCS7>>(key3, iv8),
+                       std::make_unique<modes::CBC>(std::make_unique<symmetric::TripleDES>(key3), std::make_unique<padding::PKCS7>(), iv8));
+    pairs.emplace_back(std::make_unique<modes::Mode<modes::ECB, symmetric::DES, padding::ANSIX923>>(std::span{key3}.first(8)),
+                       std::make_unique<modes::ECB>(std::make_unique<symmetric::DES>(std::span{key3}.first(8)), std::make_unique<padding::ANSIX923>()));
+    pairs.emplace_back(std::make_unique<modes::Mode<modes::CTR, symmetric::DEAL>>(key2, iv16),
+                       std::make_unique<modes::CTR>(std::make_unique<symmetric::DEAL>(key2), iv16));
+    for (auto& [composed, dynamic] : pairs) {
+        Bytes encrypted = composed->encrypt(data);
+        EXPECT_EQ(encrypted, dynamic->encrypt(data));
+        EXPECT_EQ(composed->decrypt(encrypted), data);
+    }
+}
+TEST(CpuFeatures, UnknownEnvironmentLevelIsReported) {
+    EXPECT_EQ(utils::CpuFeatures::parse("avx2"), utils::SimdLevel::AVX2);
+    EXPECT_FALSE(utils::CpuFeatures::parse("avx-512").has_value());
+    setenv(utils::CpuFeatures::ENV_VARIABLE, "avx-512", 1);
+    testing::internal::CaptureStderr();
+    utils::CpuFeatures::reset();
+    std::string warning = testing::internal::GetCapturedStderr();
+    EXPECT_EQ(utils::CpuFeatures::active(), utils::CpuFeatures::detected());
+    EXPECT_NE(warning.find("avx-512"), std::string::npos);
+    EXPECT_NE(warning.find("avx512vbmi"), std::string::npos);
+    unsetenv(utils::CpuFeatures::ENV_VARIABLE);
+    utils::CpuFeatures::reset();
+}
+TEST(BlockOps, EveryDispatchLevelMatchesScalar) {
+    Bytes a(200), b(200);
+    for (size_t i = 0; i < a.size(); ++i) {
+        a[i] = static_cast<Byte>(i * 7 + 1);
+        b[i] = static_cast<Byte>(i * 13 + 5);
+    }
+    for (auto level : {utils::SimdLevel::Scalar, utils::SimdLevel::SSSE3, utils::SimdLevel::AVX2, utils::SimdLevel::AVX512}) {
+        utils::CpuFeatures::force(level);
+        for (size_t n : {0, 5, 8, 31, 64, 127, 200}) {
+            Bytes expected(n), out(n), into(a.begin(), a.begin() + n);
+            for (size_t i = 0; i < n; ++i) expected[i] = a[i] ^ b[i];
+            utils::BlockOps::xor3(out, a, b);
+            utils::BlockOps::xorInto(into, b);
+            EXPECT_EQ(out, expected) << n;
+            EXPECT_EQ(into, expected) << n;
+            for (size_t stride : {8, 16, 40}) {
+                Bytes scan(a.begin(), a.begin() + n);
+                utils::BlockOps::prefixXor(scan, stride);
+                for (size_t i = stride; i < n; ++i) EXPECT_EQ(scan[i], scan[i - stride] ^ a[i]) << n << " " << stride;
+            }
+        }
+    }
+    utils::CpuFeatures::reset();
+    Bytes overlap{Byte{1}, Byte{2}, Byte{3}, Byte{4}};
+    utils::BlockOps::copy(overlap, std::span{overlap}.subspan(1));
+    EXPECT_EQ(overlap, (Bytes{Byte{2}, Byte{3}, Byte{4}, Byte{4}}));
+    EXPECT_THROW(utils::BlockOps::xor3(std::span{a}, std::span{b}.first(10), b), std::invalid_argument);
+}
+TEST(CMAC, TripleDESKnownAnswers) {
+    Bytes key = fromHex("8aa83bf8cbda10620bc1bf19fbb6cd58bc313d4a371ca8b5");
+    Bytes message = fromHex("6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51");
+    for (auto [length, tag] : std::vector<std::pair<size_t, std::string>>{{0, "b7a688e122ffaf95"}, {16, "286d394673448197"}, {32, "33e6b1092400eae5"}}) {
+        modes::CMAC mac(std::make_unique<symmetric::TripleDES>(key));
+        mac.update(std::span{message}.first(length));
+        Bytes actual(8);
+        mac.finalize(actual);
+        EXPECT_EQ(actual, fromHex(tag)) << length;
+    }
+}
+TEST(CMAC, DeriveKeySeparatesLabels) {
+    Bytes master = fromHex("8aa83bf8cbda10620bc1bf19fbb6cd58bc313d4a371ca8b5");
+    auto derive = [&](std::string_view label, size_t length) {
+        return modes::CMAC::deriveKey(std::make_unique<symmetric::TripleDES>(master), label, length);
+    };
+    Bytes enc = derive("encryption", 24), mac = derive("authentication", 24);
+    EXPECT_EQ(enc.size(), 24u);
+    EXPECT_EQ(enc, derive("encryption", 24));
+    EXPECT_NE(enc, mac);
+    EXPECT_NE(enc, master);
+    EXPECT_NE(Bytes(enc.begin(), enc.begin() + 8), derive("encryption", 8));
+    EXPECT_THROW(derive("encryption", 0), std::invalid_argument);
+}
+TEST(AuthenticatedCBC, TagAppendedAndVerified) {
+    Bytes key(24, Byte{0x1F}), macKey(24, Byte{0xE3}), iv(8, Byte{0x5A}), data(8 * 300 + 3);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<Byte>(i * 19 + 2);
+    auto make = [&] {
+        return modes::AuthenticatedCBC(std::make_unique<symmetric::TripleDES>(key), std::make_unique<symmetric::TripleDES>(macKey),
+                                       std::make_unique<padding::PKCS7>(), iv);
+    };
+    auto mode = make();
+    Bytes sealed = mode.encrypt(data);
+    Bytes plainCbc = modes::CBC(std::make_unique<symmetric::TripleDES>(key), std::make_unique<padding::PKCS7>(), iv).encrypt(data);
+    ASSERT_EQ(sealed.size(), plainCbc.size() + 8);
+    EXPECT_TRUE(std::equal(plainCbc.begin(), plainCbc.end(), sealed.begin()));
+    modes::CMAC mac(std::make_unique<symmetric::TripleDES>(macKey));
+    mac.update(plainCbc);
+    Bytes tag(8);
+    mac.finalize(tag);
+    EXPECT_TRUE(std::equal(tag.begin(), tag.end(), sealed.end() - 8));
+    EXPECT_EQ(make().decrypt(sealed), data);
+    for (size_t position : {size_t{5}, sealed.size() - 12, sealed.size() - 1}) {
+        Bytes tampered = sealed;
+        tampered[position] ^= Byte{0x01};
+        EXPECT_THROW(make().decrypt(tampered), std::runtime_error) << position;
+    }
+    auto dir = std::filesystem::temp_directory_path();
+    auto sealedPath = dir / "acbc_sealed.bin", openedPath = dir / "acbc_opened.bin";
+    std::filesystem::remove(openedPath);
+    {
+        std::ofstream out(sealedPath, std::ios::binary);
+        sealed[20] ^= Byte{0x80};
+        out.write(reinterpret_cast<const char*>(sealed.data()), static_cast<std::streamsize>(sealed.size()));
+    }
+    EXPECT_THROW(utils::FileProcessor::process(sealedPath, openedPath, mode, false), std::runtime_error);
+    EXPECT_FALSE(std::filesystem::exists(openedPath));
+    EXPECT_FALSE(std::filesystem::exists(dir / "acbc_opened.bin.part"));
+    std::filesystem::remove(sealedPath);
+}
+TEST(FileProcessor, BackendsMatchStream) {
+    Bytes key(8, Byte{0x6E}), macKey(8, Byte{0x1A}), iv(8, Byte{0x33});
+    Bytes data(utils::FileProcessor::CHUNK_SIZE * 2 + 8 * 1000 + 5);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<Byte>(i * 37 + i / 4096);
+    auto dir = std::filesystem::temp_directory_path();
+    auto plainPath = dir / "fp_plain.bin", streamPath = dir / "fp_stream.bin", mappedPath = dir / "fp_mapped.bin", openedPath = dir / "fp_opened.bin";
+    {
+        std::ofstream out(plainPath, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    }
+    auto readAll = [](const std::filesystem::path& path) {
+        Bytes bytes(std::filesystem::file_size(path));
+        std::ifstream in(path, std::ios::binary);
+        in.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        return bytes;
+    };
+    std::vector<std::function<std::unique_ptr<ICipherMode>()>> factories = {
+        [&] { return std::make_unique<modes::CBC>(std::make_unique<symmetric::DES>(key), std::make_unique<padding::PKCS7>(), iv); },
+        [&] { return std::make_unique<modes::CTR>(std::make_unique<symmetric::DES>(key), iv); },
+        [&] { return std::make_unique<modes::AuthenticatedCBC>(std::make_unique<symmetric::DES>(key), std::make_unique<symmetric::DES>(macKey),
+                                                               std::make_unique<padding::ANSIX923>(), iv); }
+    };
+    using Backend = utils::FileProcessor::Backend;
+    for (auto& factory : factories) {
+        utils::FileProcessor::process(plainPath, streamPath, *factory(), true, Backend::Stream);
+        utils::FileProcessor::process(plainPath, mappedPath, *factory(), true, Backend::MemoryMapped);
+        EXPECT_EQ(std::filesystem::file_size(streamPath), std::filesystem::file_size(mappedPath));
+        EXPECT_EQ(readAll(streamPath), readAll(mappedPath));
+        utils::FileProcessor::process(mappedPath, openedPath, *factory(), false, Backend::MemoryMapped);
+        EXPECT_EQ(std::filesystem::file_size(openedPath), data.size());
+        EXPECT_EQ(readAll(openedPath), data);
+        utils::FileProcessor::process(plainPath, mappedPath, *factory(), true, utils::FileProcessor::Options{Backend::Pipelined, (1 << 20) + 3, 3});
+        EXPECT_EQ(readAll(streamPath), readAll(mappedPath));
+        utils::FileProcessor::process(mappedPath, openedPath, *factory(), false, utils::FileProcessor::Options{Backend::Pipelined, 1 << 16, 2});
+        EXPECT_EQ(readAll(openedPath), data);
+        utils::FileProcessor::process(plainPath, mappedPath, *factory(), true, utils::FileProcessor::Options{Backend::Async, (1 << 20) + 3, 3, true});
+        EXPECT_EQ(readAll(streamPath), readAll(mappedPath));
+        utils::FileProcessor::process(mappedPath, openedPath, *factory(), false, utils::FileProcessor::Options{Backend::Async, 1 << 16, 1});
+        EXPECT_EQ(readAll(openedPath), data);
+        utils::FileProcessor::process(mappedPath, openedPath, *factory(), false, utils::FileProcessor::Options{Backend::Async, 1 << 20, 4, true});
+        EXPECT_EQ(readAll(openedPath), data);
+    }
+    for (const auto& path : {plainPath, streamPath, mappedPath, openedPath}) std::filesystem::remove(path);
+}
+TEST(BatchProcessor, TreeRoundTripAndReport) {
+    Bytes key(8, Byte{0x2B}), iv(8, Byte{0x71});
+    auto root = std::filesystem::temp_directory_path() / "batch_test";
+    std::filesystem::remove_all(root);
+    auto plainDir = root / "plain", encDir = root / "enc", decDir = root / "dec";
+    std::vector<size_t> sizes = {0, 1, 8, 1000, 65537, (1 << 20) + 13};
+    for (size_t f = 0; f < sizes.size(); ++f) {
+        auto path = plainDir / (f % 2 ? "odd" : "even") / ("file" + std::to_string(f) + ".bin");
+        std::filesystem::create_directories(path.parent_path());
+        Bytes data(sizes[f]);
+        for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<Byte>(i * 13 + f);
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    }
+    std::shared_ptr<IBlockCipher> shared = std::make_shared<symmetric::DES>(key);
+    utils::BatchProcessor::ModeFactory factory = [&] {
+        return std::make_unique<modes::CBC>(std::make_unique<symmetric::SharedCipher>(shared), std::make_unique<padding::PKCS7>(), iv);
+    };
+    utils::BatchProcessor::Options options;
+    options.memoryBudget = 1 << 20;
+    options.largeFileThreshold = 1 << 16;
+    options.chunkSize = 1 << 18;
+    auto encJobs = utils::BatchProcessor::scanDirectory(plainDir, encDir);
+    ASSERT_EQ(encJobs.size(), sizes.size());
+    for (const auto& r : utils::BatchProcessor::run(encJobs, factory, true, options)) {
+        EXPECT_TRUE(r.ok) << r.error;
+        EXPECT_EQ(r.bytesOut, (r.bytesIn / 8 + 1) * 8);
+    }
+    {
+        std::ofstream manifest(root / "jobs.txt");
+        manifest << "# decrypt everything back\n";
+        for (const auto& job : encJobs) {
+            manifest << std::filesystem::relative(job.output, root).string() << '\t'
+                     << std::filesystem::relative(job.input, plainDir).string() << '\n';
+        }
+        manifest << "enc/missing.bin\n";
+    }
+    auto decJobs = utils::BatchProcessor::readManifest(root / "jobs.txt", decDir);
+    ASSERT_EQ(decJobs.size(), sizes.size() + 1);
+    auto results = utils::BatchProcessor::run(decJobs, factory, false, options);
+    for (size_t i = 0; i < encJobs.size(); ++i) {
+        ASSERT_TRUE(results[i].ok) << results[i].error;
+        auto original = encJobs[i].input, restored = decDir / std::filesystem::relative(original, plainDir);
+        std::ifstream a(original, std::ios::binary), b(restored, std::ios::binary);
+        EXPECT_TRUE(std::equal(std::istreambuf_iterator<char>(a), {}, std::istreambuf_iterator<char>(b), {}));
+    }
+    EXPECT_FALSE(results.back().ok);
+    EXPECT_FALSE(results.back().error.empty());
+    std::ostringstream report;
+    utils::BatchProcessor::writeReport(results, report);
+    std::string text = report.str();
+    EXPECT_EQ(std::count(text.begin(), text.end(), '\n'), static_cast<long>(results.size() + 1));
+    std::filesystem::remove_all(root);
+}
+TEST(BatchProcessor, ManifestRejectsCollidingOutputs) {
+    Bytes key(8, Byte{0x2B}), iv(8, Byte{0x71});
+    auto root = std::filesystem::temp_directory_path() / "batch_manifest_test";
+    std::filesystem::remove_all(root);
+    for (const char* name : {"a/x.bin", "b/x.bin"}) {
+        std::filesystem::create_directories((root / "in" / name).parent_path());
+        std::ofstream(root / "in" / name, std::ios::binary) << name;
+    }
+    {
+        std::ofstream manifest(root / "in" / "jobs.txt");
+        manifest << "a/x.bin\nb/x.bin\n"
+                 << "a/x.bin\tdup.bin\nb/x.bin\tdup.bin\n"
+                 << "a/x.bin\t../escaped.bin\n"
+                 << "a/x.bin\t" << (root / "absolute.bin").string() << "\n";
+    }
+    auto jobs = utils::BatchProcessor::readManifest(root / "in" / "jobs.txt", root / "out");
+    ASSERT_EQ(jobs.size(), 6u);
+    EXPECT_EQ(jobs[0].output, root / "out" / "a" / "x.bin");
+    EXPECT_EQ(jobs[1].output, root / "out" / "b" / "x.bin");
+    utils::BatchProcessor::ModeFactory factory = [&] {
+        return std::make_unique<modes::CBC>(std::make_unique<symmetric::DES>(key), std::make_unique<padding::PKCS7>(), iv);
+    };
+    auto results = utils::BatchProcessor::run(jobs, factory, true);
+    EXPECT_TRUE(results[0].ok) << results[0].error;
+    EXPECT_TRUE(results[1].ok) << results[1].error;
+    for (size_t i = 2; i < results.size(); ++i) {
+        EXPECT_FALSE(results[i].ok);
+        EXPECT_FALSE(results[i].error.empty());
+    }
+    EXPECT_FALSE(std::filesystem::exists(root / "out" / "dup.bin"));
+    EXPECT_FALSE(std::filesystem::exists(root / "escaped.bin"));
+    EXPECT_FALSE(std::filesystem::exists(root / "absolute.bin"));
+    std::filesystem::remove_all(root);
+}
+TEST(BatchProcessor, ManifestOfAbsolutePathsMirrorsThemUnderOutput) {
+    Bytes key(8, Byte{0x2B}), iv(8, Byte{0x71});
+    auto root = std::filesystem::absolute(std::filesystem::temp_directory_path() / "batch_absolute_test");
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root / "in");
+    for (const char* name : {"one.bin", "two.bin"}) {
+        std::ofstream(root / "in" / name, std::ios::binary) << name;
+    }
+    {
+        std::ofstream manifest(root / "jobs.txt");
+        manifest << (root / "in" / "one.bin").string() << "\n"
+                 << (root / "in" / "two.bin").string() << "\n";
+    }
+    auto jobs = utils::BatchProcessor::readManifest(root / "jobs.txt", root / "out");
+    ASSERT_EQ(jobs.size(), 2u);
+    EXPECT_EQ(jobs[0].input, root / "in" / "one.bin");
+    EXPECT_EQ(jobs[0].output, root / "out" / (root / "in" / "one.bin").relative_path());
+    utils::BatchProcessor::ModeFactory factory = [&] {
+        return std::make_unique<modes::CBC>(std::make_unique<symmetric::DES>(key), std::make_unique<padding::PKCS7>(), iv);
+    };
+    for (const auto& r : utils::BatchProcessor::run(jobs, factory, true)) {
+        EXPECT_TRUE(r.ok) << r.error;
+        EXPECT_TRUE(std::filesystem::exists(r.output));
+    }
+    std::filesystem::remove_all(root);
+}
+TEST(BatchProcessor, ScanSkipsOutputNestedInInput) {
+    auto root = std::filesystem::temp_directory_path() / "batch_nested_test";
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root / "out" / "deep");
+    std::ofstream(root / "plain.bin", std::ios::binary) << "plain";
+    std::ofstream(root / "out" / "deep" / "stale.bin", std::ios::binary) << "stale";
+    auto jobs = utils::BatchProcessor::scanDirectory(root, root / "out");
+    ASSERT_EQ(jobs.size(), 1u);
+    EXPECT_EQ(jobs[0].input, root / "plain.bin");
+    EXPECT_EQ(jobs[0].output, root / "out" / "plain.bin");
+    EXPECT_THROW(utils::BatchProcessor::scanDirectory(root, root / "."), std::runtime_error);
+    std::filesystem::remove_all(root);
+}
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -6,7 +6,12 @@
 #include "crypto/modes/ECB.hpp"
 #include "crypto/modes/OFB.hpp"
 #include "crypto/modes/PCBC.hpp"
+#include "crypto/modes/CFB.hpp"
+#include "crypto/modes/CBC.hpp"
+#include "crypto/modes/CTR.hpp"
+#include "crypto/modes/MultiBufferCBC.hpp"
 #include "crypto/padding/PKCS7.hpp"
+#include "crypto/utils/CpuFeatures.hpp"
 using namespace crypto;
 TEST(FROG_Core, KeySizes) {
 
@@ -34,6 +39,58 @@ TEST(FROG_Core, BlockEncryptDecrypt) {
     frog.decryptBlock(encrypted, decrypted);
     EXPECT_EQ(original, decrypted);
 }
+TEST(FROG_Core, BatchMatchesSingleBlock) {
+    std::vector<Byte> key(16, Byte{0x3C});
+    symmetric::FROG frog(key);
+    Bytes original(16 * 43);
+    for (size_t i = 0; i < original.size(); ++i) original[i] = static_cast<Byte>(i * 7);
+    Bytes expected(original.size());
+    for (size_t i = 0; i < 43; ++i) {
+        frog.encryptBlock(std::span{original.data() + i * 16, 16}, std::span{expected.data() + i * 16, 16});
+    }
+    Bytes batch(original.size());
+    frog.encryptBlocks(original, batch, 43);
+    EXPECT_EQ(batch, expected);
+    frog.decryptBlocks(batch, batch, 43);
+    EXPECT_EQ(batch, original);
+}
+TEST(FROG_Core, EveryDispatchLevelMatchesScalar) {
+    std::vector<Byte> key(24, Byte{0x71});
+    symmetric::FROG frog(key);
+    Bytes original(16 * 133);
+    for (size_t i = 0; i < original.size(); ++i) original[i] = static_cast<Byte>(i * 31);
+    utils::CpuFeatures::force(utils::SimdLevel::Scalar);
+    Bytes expected(original.size());
+    frog.encryptBlocks(original, expected, 133);
+    for (int level = 0; level <= static_cast<int>(utils::CpuFeatures::detected()); ++level) {
+        utils::CpuFeatures::force(static_cast<utils::SimdLevel>(level));
+        Bytes batch(original.size());
+        frog.encryptBlocks(original, batch, 133);
+        EXPECT_EQ(batch, expected) << utils::CpuFeatures::toString(utils::CpuFeatures::active());
+        frog.decryptBlocks(batch, batch, 133);
+        EXPECT_EQ(batch, original);
+    }
+    utils::CpuFeatures::reset();
+}
+TEST(FROG_Core, ExpandedKeyMatchesCompact) {
+    std::vector<Byte> key(16, Byte{0x5A});
+    symmetric::FROG compact(key);
+    symmetric::FROG expanded(key, symmetric::FROG::KeyLayout::Expanded);
+    Bytes original(16 * 9);
+    for (size_t i = 0; i < original.size(); ++i) original[i] = static_cast<Byte>(i * 13);
+    Bytes a(original.size()), b(original.size());
+    compact.encryptBlocks(original, a, 9);
+    for (auto level : {utils::SimdLevel::Scalar, utils::CpuFeatures::detected()}) {
+        utils::CpuFeatures::force(level);
+        expanded.encryptBlocks(original, b, 9);
+        EXPECT_EQ(a, b) << utils::CpuFeatures::toString(level);
+        expanded.encryptBlock(std::span{original.data(), 16}, std::span{b.data(), 16});
+        EXPECT_TRUE(std::equal(a.begin(), a.begin() + 16, b.begin()));
+        expanded.decryptBlocks(a, b, 9);
+        EXPECT_EQ(b, original) << utils::CpuFeatures::toString(level);
+    }
+    utils::CpuFeatures::reset();
+}
 TEST(FROG_Integration, ECB_PKCS7) {
     std::vector<Byte> key(16, Byte{0xAA});
     auto cipher = std::make_unique<symmetric::FROG>(key);
@@ -72,4 +129,178 @@ TEST(FROG_Integration, PCBC_Propagating) {
     Bytes enc = pcbc.encrypt(data);
     Bytes dec = pcbc.decrypt(enc);
     EXPECT_EQ(data, dec);
+}
+TEST(FROG_Integration, InPlaceFeedbackModes) {
+    std::vector<Byte> key(16, Byte{0x56});
+    std::vector<Byte> iv(16, Byte{0x0F});
+    Bytes data(16 * 70 + 9);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<Byte>(i * 17 + 3);
+    std::vector<std::unique_ptr<ICipherMode>> allocating, inPlace;
+    for (auto* list : {&allocating, &inPlace}) {
+        list->push_back(std::make_unique<modes::PCBC>(std::make_unique<symmetric::FROG>(key), std::make_unique<padding::PKCS7>(), iv));
+        list->push_back(std::make_unique<modes::CFB>(std::make_unique<symmetric::FROG>(key), std::make_unique<padding::PKCS7>(), iv));
+        list->push_back(std::make_unique<modes::CFB>(std::make_unique<symmetric::FROG>(key), nullptr, iv));
+        list->push_back(std::make_unique<modes::OFB>(std::make_unique<symmetric::FROG>(key), iv));
+    }
+    for (size_t m = 0; m < allocating.size(); ++m) {
+        Bytes expected = allocating[m]->encrypt(data);
+        Bytes buffer(inPlace[m]->encryptedSize(data.size()));
+        std::copy(data.begin(), data.end(), buffer.begin());
+        size_t length = inPlace[m]->encryptInPlace(buffer, data.size());
+        buffer.resize(length);
+        EXPECT_EQ(buffer, expected) << "mode " << m;
+        buffer.resize(inPlace[m]->decryptInPlace(buffer));
+        EXPECT_EQ(buffer, data) << "mode " << m;
+    }
+}
+TEST(FROG_Integration, StreamingFeedbackModes) {
+    std::vector<Byte> key(16, Byte{0x29});
+    std::vector<Byte> iv(16, Byte{0xC3});
+    Bytes data(16 * 40 + 11);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<Byte>(i * 5 + 1);
+    std::vector<std::unique_ptr<ICipherMode>> streams;
+    streams.push_back(std::make_unique<modes::PCBC>(std::make_unique<symmetric::FROG>(key), std::make_unique<padding::PKCS7>(), iv));
+    streams.push_back(std::make_unique<modes::CFB>(std::make_unique<symmetric::FROG>(key), nullptr, iv));
+    streams.push_back(std::make_unique<modes::OFB>(std::make_unique<symmetric::FROG>(key), iv));
+    for (auto& mode : streams) {
+        Bytes expected = mode->encrypt(data);
+        Bytes streamed(data.size() + 16);
+        size_t produced = 0;
+        mode->begin(true);
+        for (size_t offset = 0; offset < data.size(); offset += 37) {
+            size_t len = std::min<size_t>(37, data.size() - offset);
+            produced += mode->update(std::span{data.data() + offset, len}, std::span{streamed.data() + produced, len + 16});
+        }
+        produced += mode->finalize(std::span{streamed.data() + produced, 16});
+        streamed.resize(produced);
+        EXPECT_EQ(streamed, expected);
+        EXPECT_EQ(mode->decrypt(streamed), data);
+    }
+}
+TEST(FROG_Integration, MultiBufferCBC) {
+    std::vector<Byte> sharedKey(16, Byte{0x44}), otherKey(20, Byte{0x17});
+    auto shared = std::make_unique<symmetric::FROG>(sharedKey);
+    auto other = std::make_unique<symmetric::FROG>(otherKey);
+    std::vector<Bytes> ivs, inputs, outputs;
+    std::vector<modes::MultiBufferCBC::Stream> streams;
+    for (size_t i = 0; i < 12; ++i) {
+        ivs.emplace_back(16, static_cast<Byte>(i));
+        inputs.emplace_back(i * 29 + 5, static_cast<Byte>(i * 3));
+        outputs.emplace_back(inputs.back().size() + 16);
+    }
+    for (size_t i = 0; i < 12; ++i) {
+        streams.push_back({i % 3 == 0 ? other.get() : shared.get(), ivs[i], inputs[i], outputs[i]});
+    }
+    modes::MultiBufferCBC engine(std::make_unique<padding::PKCS7>());
+    std::vector<size_t> sizes = engine.encrypt(streams);
+    for (size_t i = 0; i < 12; ++i) {
+        modes::CBC cbc(std::make_unique<symmetric::FROG>(i % 3 == 0 ? otherKey : sharedKey), std::make_unique<padding::PKCS7>(), ivs[i]);
+        Bytes expected = cbc.encrypt(inputs[i]);
+        ASSERT_EQ(sizes[i], expected.size());
+        EXPECT_TRUE(std::equal(expected.begin(), expected.end(), outputs[i].begin())) << "stream " << i;
+    }
+}
+TEST(FROG_Integration, CTR_FullWidthCounter) {
+    std::vector<Byte> key(16, Byte{0x61});
+    Bytes iv(16, Byte{0xFF});
+    iv[7] = Byte{0x10};
+    modes::CTR ctr(std::make_unique<symmetric::FROG>(key), iv);
+    Bytes keystream = ctr.encrypt(Bytes(32, Byte{0}));
+    symmetric::FROG frog(key);
+    Bytes expected(32);
+    frog.encryptBlock(iv, std::span{expected.data(), 16});
+    Bytes next = iv;
+    next[7] = Byte{0x11};
+    std::fill(next.begin() + 8, next.end(), Byte{0});
+    frog.encryptBlock(next, std::span{expected.data() + 16, 16});
+    EXPECT_EQ(keystream, expected);
+}
+TEST(FROG_Integration, CTR_RandomAccess) {
+    std::vector<Byte> key(16, Byte{0x62});
+    Bytes iv(16);
+    for (size_t i = 0; i < iv.size(); ++i) iv[i] = static_cast<Byte>(0xF0 + i);
+    Bytes data(16 * 3000 + 7);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<Byte>(i * 11);
+    modes::CTR ctr(std::make_unique<symmetric::FROG>(key), iv);
+    Bytes encrypted = ctr.encrypt(data);
+    for (auto [offset, len] : std::vector<std::pair<size_t, size_t>>{{0, 5}, {13, 40}, {16 * 1500 + 3, 16 * 1200}, {data.size() - 9, 9}}) {
+        Bytes part(len);
+        ctr.processRange(offset, std::span{encrypted.data() + offset, len}, part);
+        EXPECT_TRUE(std::equal(part.begin(), part.end(), data.begin() + offset)) << offset;
+    }
+    size_t offset = 16 * 2000 + 5;
+    Bytes tail(data.size() - offset + 16);
+    ctr.seek(offset);
+    size_t produced = ctr.update(std::span{encrypted.data() + offset, encrypted.size() - offset}, tail);
+    produced += ctr.finalize(std::span{tail.data() + produced, tail.size() - produced});
+    ASSERT_EQ(produced, data.size() - offset);
+    EXPECT_TRUE(std::equal(tail.begin(), tail.begin() + produced, data.begin() + offset));
+}
+TEST(FROG_Integration, OFB_PrefetchMatchesInline) {
+    std::vector<Byte> key(16, Byte{0x3E});
+    Bytes iv(16, Byte{0x9D});
+    Bytes data(modes::OFB::PREFETCH_MIN_BYTES * 5 + 23);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<Byte>(i * 7 + i / 255);
+    modes::OFB prefetching(std::make_unique<symmetric::FROG>(key), iv);
+    Bytes encrypted = prefetching.encrypt(data);
+    modes::OFB inlineMode(std::make_unique<symmetric::FROG>(key), iv);
+    Bytes expected(data.size());
+    size_t produced = 0;
+    inlineMode.begin(true);
+    for (size_t offset = 0; offset < data.size(); offset += 1000) {
+        size_t len = std::min<size_t>(1000, data.size() - offset);
+        produced += inlineMode.update(std::span{data.data() + offset, len}, std::span{expected.data() + produced, expected.size() - produced});
+    }
+    produced += inlineMode.finalize(std::span{expected.data() + produced, expected.size() - produced});
+    ASSERT_EQ(produced, data.size());
+    EXPECT_EQ(encrypted, expected);
+    EXPECT_EQ(prefetching.decrypt(encrypted), data);
+}
+TEST(FROG_Integration, OFB_PrefetchFailureReachesCaller) {
+    class FailingCipher : public IBlockCipher {
+        symmetric::FROG inner;
+        size_t remaining;
+    public:
+        FailingCipher(ConstBytesSpan key, size_t blocks) : inner(key), remaining(blocks) {}
+        [[nodiscard]] size_t getBlockSize() const override { return inner.getBlockSize(); }
+        [[nodiscard]] size_t getKeySize() const override { return inner.getKeySize(); }
+        void encryptBlock(ConstBytesSpan src, BytesSpan dst) override {
+            if (remaining-- == 0) throw std::runtime_error("cipher failed");
+            inner.encryptBlock(src, dst);
+        }
+        void decryptBlock(ConstBytesSpan src, BytesSpan dst) override { inner.decryptBlock(src, dst); }
+    };
+    Bytes key(16, Byte{0x3E}), iv(16, Byte{0x9D});
+    Bytes data(modes::OFB::PREFETCH_MIN_BYTES * 5);
+    size_t blocks = modes::OFB::SEGMENT_BLOCKS + 10;
+    modes::OFB ofb(std::make_unique<FailingCipher>(key, blocks), iv);
+    EXPECT_THROW(ofb.encrypt(data), std::runtime_error);
+}
+TEST(FROG_Integration, CFB_SegmentSizes) {
+    std::vector<Byte> key(16, Byte{0x4B});
+    Bytes iv(16);
+    for (size_t i = 0; i < iv.size(); ++i) iv[i] = static_cast<Byte>(i * 13 + 1);
+    Bytes data(16 * 300 + 5);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<Byte>(i * 3 + i / 7);
+    symmetric::FROG frog(key);
+    for (size_t segment : {1, 4, 8, 16}) {
+        Bytes expected(data.size()), reg = iv, keystream(16);
+        for (size_t offset = 0; offset < data.size(); offset += segment) {
+            size_t len = std::min(segment, data.size() - offset);
+            frog.encryptBlock(reg, keystream);
+            for (size_t j = 0; j < len; ++j) expected[offset + j] = data[offset + j] ^ keystream[j];
+            std::rotate(reg.begin(), reg.begin() + len, reg.end());
+            std::copy_n(expected.begin() + offset, len, reg.end() - len);
+        }
+        modes::CFB cfb(std::make_unique<symmetric::FROG>(key), nullptr, iv, segment);
+        Bytes encrypted = cfb.encrypt(data);
+        EXPECT_EQ(encrypted, expected) << segment;
+        for (utils::ScheduleOptions options : {utils::ScheduleOptions{}, utils::ScheduleOptions{1, 0}, utils::ScheduleOptions{37, 0}}) {
+            cfb.setSchedule(options);
+            Bytes buffer = encrypted;
+            cfb.decryptInPlace(buffer);
+            EXPECT_EQ(buffer, data) << segment << " " << options.grainBlocks;
+        }
+    }
+    EXPECT_THROW(modes::CFB(std::make_unique<symmetric::FROG>(key), nullptr, iv, 3), std::invalid_argument);
 }
\ No newline at end of file